@@ -0,0 +1,56 @@
+#include "BenchmarkUtils.h"
+
+#include <cstdio>
+#include <string_view>
+
+namespace brr::bench
+{
+	struct RegisteredBenchmark
+	{
+		const char* name;
+		BenchmarkFunc function;
+	};
+
+	static std::vector<RegisteredBenchmark>& GetBenchmarks()
+	{
+		// Function static, since benchmarks are registered during static initialization of the other files.
+		static std::vector<RegisteredBenchmark> benchmarks;
+		return benchmarks;
+	}
+
+	bool RegisterBenchmark(const char* name, BenchmarkFunc function)
+	{
+		GetBenchmarks().push_back({name, function});
+		return true;
+	}
+
+	void ReportResult(const char* case_name, double milliseconds, size_t items_count)
+	{
+		if (items_count == 0)
+		{
+			std::printf("  %-48s %12.3f ms\n", case_name, milliseconds);
+			return;
+		}
+		std::printf("  %-48s %12.3f ms %12.2f ns/item\n", case_name, milliseconds,
+		            milliseconds * 1e6 / static_cast<double>(items_count));
+	}
+}
+
+/**
+ * Runs every registered benchmark, or only the ones whose name contains the first argument.
+ */
+int main(int argc, char** argv)
+{
+	const std::string_view filter = argc > 1 ? argv[1] : "";
+	for (const brr::bench::RegisteredBenchmark& benchmark : brr::bench::GetBenchmarks())
+	{
+		if (std::string_view(benchmark.name).find(filter) == std::string_view::npos)
+		{
+			continue;
+		}
+		std::printf("%s\n", benchmark.name);
+		benchmark.function();
+		std::fflush(stdout);
+	}
+	return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef BRR_BENCHMARKUTILS_H
+#define BRR_BENCHMARKUTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace brr::bench
+{
+	using BenchmarkFunc = void(*)();
+
+	/**
+	 * \brief Register a benchmark to be run by the benchmarks executable. Used by BRR_BENCHMARK.
+	 */
+	bool RegisterBenchmark(const char* name, BenchmarkFunc function);
+
+	/**
+	 * \brief Print the time of a benchmark case, and the time per item when 'items_count' is not zero.
+	 */
+	void ReportResult(const char* case_name, double milliseconds, size_t items_count = 0);
+
+	/**
+	 * \brief Run 'func' 'repetitions' times.
+	 * \return Median duration of the runs in milliseconds.
+	 */
+	template <typename Func>
+	double MeasureMilliseconds(uint32_t repetitions, Func&& func)
+	{
+		std::vector<double> durations;
+		durations.reserve(repetitions);
+		for (uint32_t repetition = 0; repetition < repetitions; repetition++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			const auto end = std::chrono::steady_clock::now();
+			durations.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+		std::ranges::nth_element(durations, durations.begin() + durations.size() / 2);
+		return durations[durations.size() / 2];
+	}
+
+	// Thread local, since benchmarks call DoNotOptimize from several threads at once.
+	inline thread_local volatile const void* g_optimizer_sink = nullptr;
+
+	/**
+	 * \brief Prevent the compiler from discarding the computation of 'value'.
+	 */
+	template <typename T>
+	void DoNotOptimize(const T& value)
+	{
+		g_optimizer_sink = &value;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+	}
+}
+
+/**
+ * \brief Define a benchmark function and register it in the benchmarks executable.
+ */
+#define BRR_BENCHMARK(name) \
+	static void name(); \
+	static const bool name##_registered = ::brr::bench::RegisterBenchmark(#name, &name); \
+	static void name()
+
+#endif
@@ -0,0 +1,98 @@
+#include "BenchmarkUtils.h"
+
+#include <Core/Storage/ContiguousPool.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace brr;
+
+namespace
+{
+	constexpr uint32_t REPETITIONS = 10;
+	constexpr uint32_t ELEMENTS_COUNT = 100000;
+	// Each churn round removes and adds back this many elements, in random order.
+	constexpr uint32_t CHURN_COUNT = ELEMENTS_COUNT / 2;
+	constexpr uint32_t CHURN_ROUNDS = 4;
+
+	struct PoolElement
+	{
+		float values[8] {};
+	};
+
+	struct ChurnKeys
+	{
+		ChurnKeys()
+		: keys(ELEMENTS_COUNT)
+		{
+			std::iota(keys.begin(), keys.end(), 0u);
+			std::mt19937 random (3);
+			for (std::vector<uint32_t>& round_keys : churn_keys)
+			{
+				std::ranges::shuffle(keys, random);
+				round_keys.assign(keys.begin(), keys.begin() + CHURN_COUNT);
+			}
+			std::ranges::shuffle(keys, random);
+		}
+
+		std::vector<uint32_t> keys;
+		std::vector<uint32_t> churn_keys[CHURN_ROUNDS];
+	};
+
+	template <typename AddFunc, typename RemoveFunc, typename ContainsFunc>
+	void RunChurn(const ChurnKeys& keys, AddFunc&& add, RemoveFunc&& remove, ContainsFunc&& contains)
+	{
+		for (uint32_t key : keys.keys)
+		{
+			add(key);
+		}
+		size_t found_count = 0;
+		for (const std::vector<uint32_t>& round_keys : keys.churn_keys)
+		{
+			for (uint32_t key : round_keys)
+			{
+				remove(key);
+			}
+			for (uint32_t key : keys.keys)
+			{
+				found_count += contains(key);
+			}
+			for (uint32_t key : round_keys)
+			{
+				add(key);
+			}
+		}
+		bench::DoNotOptimize(found_count);
+	}
+}
+
+/*
+ * Fill 100k elements, then remove and add back half of them in random order, looking up every key between each
+ * removal and addition. Compared with std::unordered_map, which hashes on every operation.
+ */
+BRR_BENCHMARK(ContiguousPoolChurn)
+{
+	const ChurnKeys keys;
+	const size_t operations_count = ELEMENTS_COUNT + CHURN_ROUNDS * (2 * CHURN_COUNT + ELEMENTS_COUNT);
+
+	bench::ReportResult("ContiguousPool", bench::MeasureMilliseconds(REPETITIONS, [&]
+	{
+		ContiguousPool<uint32_t, PoolElement> pool;
+		RunChurn(keys,
+		         [&pool](uint32_t key) { pool.AddObject(key, PoolElement{}); },
+		         [&pool](uint32_t key) { pool.RemoveObject(key); },
+		         [&pool](uint32_t key) { return pool.Contains(key); });
+	}), operations_count);
+
+	bench::ReportResult("std::unordered_map", bench::MeasureMilliseconds(REPETITIONS, [&]
+	{
+		std::unordered_map<uint32_t, PoolElement> map;
+		RunChurn(keys,
+		         [&map](uint32_t key) { map.emplace(key, PoolElement{}); },
+		         [&map](uint32_t key) { map.erase(key); },
+		         [&map](uint32_t key) { return map.contains(key); });
+	}), operations_count);
+}
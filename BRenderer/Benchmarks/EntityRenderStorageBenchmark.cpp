@@ -0,0 +1,128 @@
+#include "BenchmarkUtils.h"
+
+#include <Renderer/Internal/EntityRenderStorage.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace brr;
+using namespace brr::render;
+
+namespace
+{
+	constexpr uint32_t REPETITIONS = 5;
+	constexpr uint32_t ENTITIES_COUNTS[] = {10000, 100000, 1000000};
+	// Fraction of the entities removed and added back by the churn case, and marked dirty by the sweep case.
+	constexpr uint32_t CHANGED_ENTITIES_DIVISOR = 10;
+
+	using internal::EntityRenderStorage;
+
+	EntityID MakeEntityId(uint32_t index)
+	{
+		return MakeRenderId<EntityID>(index, 0);
+	}
+
+	void FillStorage(EntityRenderStorage& storage, uint32_t entities_count)
+	{
+		for (uint32_t index = 0; index < entities_count; index++)
+		{
+			storage.Add(MakeEntityId(index), glm::translate(glm::vec3(static_cast<float>(index), 0.0f, 0.0f)));
+		}
+	}
+
+	// Same sweep as SceneRenderer::Render, with 'objects' standing in for the mapped object buffer.
+	void SweepDirtyEntities(EntityRenderStorage& storage, std::vector<glm::mat4>& objects, uint8_t current_buffer_bit)
+	{
+		const uint32_t entities_count = storage.Size();
+		for (uint32_t entity_slot = 0; entity_slot < entities_count; ++entity_slot)
+		{
+			uint8_t& dirty_flags = storage.dirty_flags[entity_slot];
+			if (dirty_flags == 0)
+			{
+				continue;
+			}
+
+			if (dirty_flags & current_buffer_bit)
+			{
+				objects[entity_slot] = storage.transforms[entity_slot];
+			}
+
+			if (dirty_flags & EntityRenderStorage::BOUNDS_DIRTY_BIT)
+			{
+				storage.bounds[entity_slot] = storage.local_bounds[entity_slot].Transformed(storage.transforms[entity_slot]);
+			}
+
+			dirty_flags &= ~(current_buffer_bit | EntityRenderStorage::BOUNDS_DIRTY_BIT);
+		}
+	}
+
+	void RunEntitiesCount(uint32_t entities_count)
+	{
+		const uint32_t changed_count = entities_count / CHANGED_ENTITIES_DIVISOR;
+		std::vector<uint32_t> changed_indices (entities_count);
+		std::iota(changed_indices.begin(), changed_indices.end(), 0u);
+		std::mt19937 random (5);
+		std::ranges::shuffle(changed_indices, random);
+		changed_indices.resize(changed_count);
+
+		const std::string count_name = std::to_string(entities_count);
+
+		const std::string add_case = count_name + " add";
+		bench::ReportResult(add_case.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&]
+		{
+			EntityRenderStorage storage;
+			FillStorage(storage, entities_count);
+			bench::DoNotOptimize(storage);
+		}), entities_count);
+
+		EntityRenderStorage storage;
+		FillStorage(storage, entities_count);
+
+		const std::string churn_case = count_name + " remove/add 10%";
+		bench::ReportResult(churn_case.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&]
+		{
+			for (uint32_t index : changed_indices)
+			{
+				storage.Remove(MakeEntityId(index));
+			}
+			for (uint32_t index : changed_indices)
+			{
+				storage.Add(MakeEntityId(index), glm::mat4(1.0f));
+			}
+		}), 2 * changed_count);
+
+		// Clear the flags of the added entities, so only the entities marked by the sweep case are dirty.
+		std::ranges::fill(storage.dirty_flags, uint8_t(0));
+		std::vector<glm::mat4> objects (entities_count);
+		uint8_t current_buffer = 0;
+
+		const std::string sweep_case = count_name + " dirty sweep 10%";
+		bench::ReportResult(sweep_case.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&]
+		{
+			for (uint32_t index : changed_indices)
+			{
+				storage.dirty_flags[storage.GetSlot(MakeEntityId(index))] |= EntityRenderStorage::TRANSFORM_DIRTY_MASK
+				                                                            | EntityRenderStorage::BOUNDS_DIRTY_BIT;
+			}
+			SweepDirtyEntities(storage, objects, static_cast<uint8_t>(1u << current_buffer));
+			current_buffer = (current_buffer + 1) % FRAME_LAG;
+		}), entities_count);
+
+		bench::DoNotOptimize(objects);
+	}
+}
+
+/*
+ * CPU side of the entity render state: adding entities, removing and adding back a random 10% of them, and the
+ * per-frame sweep over the dirty flags with a random 10% of the entities dirty.
+ */
+BRR_BENCHMARK(EntityRenderStorageUpdates)
+{
+	for (uint32_t entities_count : ENTITIES_COUNTS)
+	{
+		RunEntitiesCount(entities_count);
+	}
+}
@@ -0,0 +1,78 @@
+#include "BenchmarkUtils.h"
+
+#include <Core/thirdpartiesInc.h>
+#include <Core/Threading/ParallelFor.h>
+#include <Core/Threading/ThreadPool.h>
+#include <Core/Threading/Work.h>
+
+#include <vector>
+
+using namespace brr;
+
+namespace
+{
+	constexpr uint32_t REPETITIONS = 20;
+	constexpr size_t POINTS_COUNT = 1000000;
+	constexpr size_t FIXED_CHUNK_SIZE = 1024;
+
+	struct TransformLoopData
+	{
+		TransformLoopData()
+		: input(POINTS_COUNT), output(POINTS_COUNT)
+		{
+			for (size_t index = 0; index < POINTS_COUNT; index++)
+			{
+				input[index] = glm::vec4(static_cast<float>(index), static_cast<float>(index % 7), 1.0f, 1.0f);
+			}
+		}
+
+		void TransformRange(size_t begin, size_t end)
+		{
+			for (size_t index = begin; index < end; index++)
+			{
+				output[index] = transform * input[index];
+			}
+		}
+
+		glm::mat4 transform = glm::translate(glm::vec3(1.0f, 2.0f, 3.0f)) * glm::rotate(0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+		std::vector<glm::vec4> input;
+		std::vector<glm::vec4> output;
+	};
+}
+
+/*
+ * Transform of 1M points by a matrix, comparing ForLoopWork, which calls a std::function per index, with ParallelFor,
+ * whose kernel is inlined and receives whole chunks.
+ */
+BRR_BENCHMARK(ParallelForTransformLoop)
+{
+	thread::ThreadPool& thread_pool = thread::ThreadPool::GetDefaultPool();
+	TransformLoopData data;
+
+	bench::ReportResult("serial loop", bench::MeasureMilliseconds(REPETITIONS, [&]
+	{
+		data.TransformRange(0, POINTS_COUNT);
+	}), POINTS_COUNT);
+
+	bench::ReportResult("ForLoopWork", bench::MeasureMilliseconds(REPETITIONS, [&]
+	{
+		thread_pool.DoWorkParallel(std::make_shared<thread::ForLoopWork<size_t>>(POINTS_COUNT, FIXED_CHUNK_SIZE, [&data](size_t index)
+		{
+			data.output[index] = data.transform * data.input[index];
+		}));
+	}), POINTS_COUNT);
+
+	bench::ReportResult("ParallelFor fixed chunks", bench::MeasureMilliseconds(REPETITIONS, [&]
+	{
+		thread::ParallelFor(0, POINTS_COUNT, [&data](size_t begin, size_t end) { data.TransformRange(begin, end); },
+		                    FIXED_CHUNK_SIZE, thread::WorkPriority::Normal, thread_pool);
+	}), POINTS_COUNT);
+
+	bench::ReportResult("ParallelFor adaptive chunks", bench::MeasureMilliseconds(REPETITIONS, [&]
+	{
+		thread::ParallelFor(0, POINTS_COUNT, [&data](size_t begin, size_t end) { data.TransformRange(begin, end); },
+		                    thread::AUTO_CHUNK_SIZE, thread::WorkPriority::Normal, thread_pool);
+	}), POINTS_COUNT);
+
+	bench::DoNotOptimize(data.output);
+}
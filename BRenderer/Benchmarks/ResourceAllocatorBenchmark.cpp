@@ -0,0 +1,211 @@
+#include "BenchmarkUtils.h"
+
+#include <Core/Storage/ResourceAllocator.h>
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace brr;
+
+namespace
+{
+	/**
+	 * \brief Copy of the ResourceAllocator before the lock-free lookups, used as baseline.
+	 *        Every operation locks one allocator-wide mutex, and free slots are kept in a std::set.
+	 */
+	template <typename T>
+	class MutexResourceAllocator
+	{
+	public:
+		using Handle = uint64_t;
+
+		explicit MutexResourceAllocator(size_t chunk_size = 65536)
+		: m_elementsInChunk(static_cast<uint32_t>(std::max<size_t>(chunk_size / sizeof(T), 1)))
+		{
+			AllocateChunk();
+		}
+
+		Handle CreateResource()
+		{
+			std::lock_guard lock (m_mutex);
+			if (m_freeSet.empty())
+			{
+				AllocateChunk();
+			}
+			const uint32_t free_idx = *m_freeSet.begin();
+			m_freeSet.erase(m_freeSet.begin());
+
+			const uint32_t validation = m_nextValidation++;
+			m_validation[free_idx] = validation;
+			std::construct_at(GetElement(free_idx));
+			return (static_cast<Handle>(validation) << 32) | free_idx;
+		}
+
+		bool DestroyResource(Handle handle)
+		{
+			std::lock_guard lock (m_mutex);
+			if (!OwnsHandle(handle))
+			{
+				return false;
+			}
+			const uint32_t index = static_cast<uint32_t>(handle);
+			m_validation[index] = INVALID_VALIDATION;
+			m_freeSet.insert(index);
+			std::destroy_at(GetElement(index));
+			return true;
+		}
+
+		T* GetResource(Handle handle) const
+		{
+			std::lock_guard lock (m_mutex);
+			return OwnsHandle(handle) ? GetElement(static_cast<uint32_t>(handle)) : nullptr;
+		}
+
+	private:
+		static constexpr uint32_t INVALID_VALIDATION = ~uint32_t(0);
+
+		void AllocateChunk()
+		{
+			const uint32_t previous_size = static_cast<uint32_t>(m_validation.size());
+			m_chunks.push_back(std::make_unique<T[]>(m_elementsInChunk));
+			m_validation.resize(previous_size + m_elementsInChunk, INVALID_VALIDATION);
+			for (uint32_t index = previous_size; index < m_validation.size(); index++)
+			{
+				m_freeSet.insert(index);
+			}
+		}
+
+		bool OwnsHandle(Handle handle) const
+		{
+			const uint32_t index = static_cast<uint32_t>(handle);
+			const uint32_t validation = static_cast<uint32_t>(handle >> 32);
+			return index < m_validation.size() && validation != INVALID_VALIDATION && m_validation[index] == validation;
+		}
+
+		T* GetElement(uint32_t index) const
+		{
+			return &m_chunks[index / m_elementsInChunk][index % m_elementsInChunk];
+		}
+
+		std::vector<std::unique_ptr<T[]>> m_chunks;
+		std::vector<uint32_t> m_validation;
+		std::set<uint32_t> m_freeSet;
+		const uint32_t m_elementsInChunk;
+		uint32_t m_nextValidation = 0;
+		mutable std::mutex m_mutex;
+	};
+
+	struct Resource
+	{
+		uint64_t values[4] {};
+	};
+
+	constexpr uint32_t REPETITIONS = 5;
+	constexpr size_t LOOKUP_RESOURCES_COUNT = 65536;
+	constexpr size_t LOOKUPS_PER_THREAD = 1000000;
+	// Each churn round of a thread creates this many resources, looks each of them up and destroys them.
+	constexpr size_t CHURN_BATCH_SIZE = 256;
+	constexpr size_t CHURN_ROUNDS_PER_THREAD = 400;
+
+	template <typename Func>
+	void RunThreads(size_t num_threads, Func&& func)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(num_threads);
+		for (size_t thread_idx = 0; thread_idx < num_threads; thread_idx++)
+		{
+			threads.emplace_back(func, thread_idx);
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	// Every thread looks up resources created up front, in a different order per thread.
+	template <typename Allocator>
+	void RunLookups(const char* allocator_name, Allocator& allocator, size_t num_threads)
+	{
+		std::vector<decltype(allocator.CreateResource())> handles;
+		handles.reserve(LOOKUP_RESOURCES_COUNT);
+		for (size_t index = 0; index < LOOKUP_RESOURCES_COUNT; index++)
+		{
+			handles.push_back(allocator.CreateResource());
+		}
+
+		const std::string case_name = std::string(allocator_name) + " GetResource";
+		bench::ReportResult(case_name.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&]
+		{
+			RunThreads(num_threads, [&](size_t thread_idx)
+			{
+				uint64_t sum = 0;
+				size_t handle_idx = thread_idx * 977;
+				for (size_t lookup = 0; lookup < LOOKUPS_PER_THREAD; lookup++)
+				{
+					handle_idx = (handle_idx + 7919) % LOOKUP_RESOURCES_COUNT;
+					sum += allocator.GetResource(handles[handle_idx])->values[0];
+				}
+				bench::DoNotOptimize(sum);
+			});
+		}), num_threads * LOOKUPS_PER_THREAD);
+
+		for (const auto& handle : handles)
+		{
+			allocator.DestroyResource(handle);
+		}
+	}
+
+	// Every thread creates, looks up and destroys its own batches of resources.
+	template <typename Allocator>
+	void RunChurn(const char* allocator_name, Allocator& allocator, size_t num_threads)
+	{
+		const std::string case_name = std::string(allocator_name) + " create/destroy";
+		bench::ReportResult(case_name.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&]
+		{
+			RunThreads(num_threads, [&](size_t)
+			{
+				std::vector<decltype(allocator.CreateResource())> handles (CHURN_BATCH_SIZE);
+				uint64_t sum = 0;
+				for (size_t round = 0; round < CHURN_ROUNDS_PER_THREAD; round++)
+				{
+					for (auto& handle : handles)
+					{
+						handle = allocator.CreateResource();
+					}
+					for (const auto& handle : handles)
+					{
+						sum += allocator.GetResource(handle)->values[0];
+					}
+					for (const auto& handle : handles)
+					{
+						allocator.DestroyResource(handle);
+					}
+				}
+				bench::DoNotOptimize(sum);
+			});
+		}), num_threads * CHURN_ROUNDS_PER_THREAD * CHURN_BATCH_SIZE);
+	}
+}
+
+/*
+ * Lookups and create/destroy of resources from several threads at once, where the baseline serializes every
+ * operation on its mutex.
+ */
+BRR_BENCHMARK(ResourceAllocatorContention)
+{
+	const size_t num_threads = std::max<unsigned>(std::thread::hardware_concurrency(), 2);
+	{
+		MutexResourceAllocator<Resource> mutex_allocator;
+		RunLookups("mutex", mutex_allocator, num_threads);
+		RunChurn("mutex", mutex_allocator, num_threads);
+	}
+	{
+		ResourceAllocator<Resource> allocator;
+		RunLookups("lock-free", allocator, num_threads);
+		RunChurn("lock-free", allocator, num_threads);
+	}
+}
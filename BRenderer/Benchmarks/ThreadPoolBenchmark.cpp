@@ -0,0 +1,172 @@
+#include "BenchmarkUtils.h"
+
+#include <Core/Threading/ThreadPool.h>
+#include <Core/Threading/Work.h>
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace brr;
+
+namespace
+{
+	/**
+	 * \brief Copy of the ThreadPool scheduling before the work-stealing scheduler, used as baseline.
+	 *        Every Work is stored in one list behind one mutex, which every worker locks to take each chunk,
+	 *        and every queue and finish notifies all the workers.
+	 */
+	class MutexQueuePool
+	{
+	public:
+		explicit MutexQueuePool(size_t num_threads)
+		{
+			for (size_t index = 0; index < num_threads; index++)
+			{
+				m_workerThreads.emplace_back(&MutexQueuePool::WorkerThreadFunc, this);
+			}
+		}
+
+		~MutexQueuePool()
+		{
+			{
+				std::lock_guard lock (m_workQueueMutex);
+				m_stopWorkerThreads = true;
+			}
+			m_workReadyCondition.notify_all();
+			for (std::thread& thread : m_workerThreads)
+			{
+				thread.join();
+			}
+		}
+
+		void QueueWork(std::shared_ptr<thread::Work> work)
+		{
+			std::lock_guard lock (m_workQueueMutex);
+			m_workQueue.emplace_back(std::move(work));
+			m_workReadyCondition.notify_all();
+		}
+
+	private:
+		void WorkerThreadFunc()
+		{
+			std::unique_lock lock (m_workQueueMutex);
+			while (!m_stopWorkerThreads)
+			{
+				if (m_workQueue.empty())
+				{
+					m_workReadyCondition.wait(lock);
+					continue;
+				}
+
+				const std::shared_ptr<thread::Work> work = m_workQueue.front();
+				if (work->WillFinishOnNextExecute())
+				{
+					m_workQueue.pop_front();
+				}
+
+				lock.unlock();
+				work->Execute();
+				lock.lock();
+
+				if (work->Finished())
+				{
+					m_workReadyCondition.notify_all();
+				}
+			}
+		}
+
+		std::list<std::shared_ptr<thread::Work>> m_workQueue;
+		std::vector<std::thread> m_workerThreads;
+		std::mutex m_workQueueMutex;
+		std::condition_variable m_workReadyCondition;
+		bool m_stopWorkerThreads = false;
+	};
+
+	constexpr uint32_t REPETITIONS = 5;
+	constexpr size_t FAN_OUT_TASKS_COUNT = 100000;
+	constexpr size_t NESTED_PARENTS_COUNT = 256;
+	constexpr size_t NESTED_CHILDREN_COUNT = 256;
+	// Iterations of the busy loop of each task, so tasks are small compared to the scheduling cost.
+	constexpr uint32_t TASK_WORK_ITERATIONS = 64;
+
+	void DoTaskWork(std::atomic<size_t>& finished_tasks)
+	{
+		uint32_t value = 1;
+		for (uint32_t iteration = 0; iteration < TASK_WORK_ITERATIONS; iteration++)
+		{
+			value = value * 1664525u + 1013904223u;
+		}
+		bench::DoNotOptimize(value);
+		finished_tasks.fetch_add(1, std::memory_order_release);
+	}
+
+	void WaitTasks(const std::atomic<size_t>& finished_tasks, size_t tasks_count)
+	{
+		while (finished_tasks.load(std::memory_order_acquire) != tasks_count)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// Tasks queued one by one from a thread outside the pool.
+	template <typename Pool>
+	void RunFanOut(Pool& pool)
+	{
+		std::atomic<size_t> finished_tasks = 0;
+		for (size_t task = 0; task < FAN_OUT_TASKS_COUNT; task++)
+		{
+			pool.QueueWork(std::make_shared<thread::FunctionWork<>>([&finished_tasks] { DoTaskWork(finished_tasks); }));
+		}
+		WaitTasks(finished_tasks, FAN_OUT_TASKS_COUNT);
+	}
+
+	// Tasks queued by other tasks, from the worker threads.
+	template <typename Pool>
+	void RunNested(Pool& pool)
+	{
+		std::atomic<size_t> finished_tasks = 0;
+		for (size_t parent = 0; parent < NESTED_PARENTS_COUNT; parent++)
+		{
+			pool.QueueWork(std::make_shared<thread::FunctionWork<>>([&pool, &finished_tasks]
+			{
+				for (size_t child = 0; child < NESTED_CHILDREN_COUNT; child++)
+				{
+					pool.QueueWork(std::make_shared<thread::FunctionWork<>>([&finished_tasks] { DoTaskWork(finished_tasks); }));
+				}
+				DoTaskWork(finished_tasks);
+			}));
+		}
+		WaitTasks(finished_tasks, NESTED_PARENTS_COUNT * (NESTED_CHILDREN_COUNT + 1));
+	}
+
+	template <typename Pool>
+	void RunPoolCases(const char* pool_name, Pool& pool)
+	{
+		const std::string fan_out_case = std::string(pool_name) + " fan-out";
+		bench::ReportResult(fan_out_case.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&] { RunFanOut(pool); }),
+		                    FAN_OUT_TASKS_COUNT);
+
+		const std::string nested_case = std::string(pool_name) + " nested";
+		bench::ReportResult(nested_case.c_str(), bench::MeasureMilliseconds(REPETITIONS, [&] { RunNested(pool); }),
+		                    NESTED_PARENTS_COUNT * (NESTED_CHILDREN_COUNT + 1));
+	}
+}
+
+/*
+ * Scheduling cost of many small tasks, with every worker contending for new work.
+ */
+BRR_BENCHMARK(ThreadPoolContention)
+{
+	const size_t num_threads = std::max<unsigned>(std::thread::hardware_concurrency(), 2) - 1;
+	{
+		MutexQueuePool mutex_pool (num_threads);
+		RunPoolCases("mutex queue", mutex_pool);
+	}
+	{
+		thread::ThreadPool work_stealing_pool (num_threads);
+		RunPoolCases("work stealing", work_stealing_pool);
+	}
+}
@@ -1,6 +1,8 @@
 #include "Engine.h"
 
 #include <Core/Inputs/InputSystem.h>
+#include <Core/Threading/MainThread.h>
+#include <Core/Threading/ThreadPool.h>
 
 #include <Importer/Importer.h>
 
@@ -24,9 +26,62 @@ namespace brr
 
     static std::unique_ptr<Scene> s_main_scene {};
 
+    static thread::EngineThreadsConfig s_threads_config {};
+
+    // Maximum time spent per frame executing tasks queued to the main thread.
+    static constexpr std::chrono::microseconds MAIN_THREAD_TASKS_TIME_BUDGET {4000};
+
+    static void ConfigureEngineThreads(thread::EngineThreadsConfig threads_config)
+    {
+        std::vector<uint32_t> available_cpus = thread::GetAvailableCpus();
+        if (threads_config.reserve_render_core)
+        {
+            if (available_cpus.size() > 1)
+            {
+                // Reserve the last CPU for the render thread, and keep every other engine thread out of it.
+                const uint32_t render_cpu = available_cpus.back();
+                available_cpus.pop_back();
+                threads_config.render_thread.cpu_affinity = { render_cpu };
+                if (threads_config.main_thread.cpu_affinity.empty())
+                {
+                    threads_config.main_thread.cpu_affinity = available_cpus;
+                }
+                if (threads_config.worker_threads.cpu_affinity.empty())
+                {
+                    threads_config.worker_threads.cpu_affinity = available_cpus;
+                }
+                BRR_LogInfo("Reserving CPU {} for the render thread.", render_cpu);
+            }
+            else
+            {
+                BRR_LogWarn("Can't reserve a CPU for the render thread. Only one CPU is available.");
+            }
+        }
+
+        thread::ApplyThreadConfig(threads_config.main_thread);
+        render::RenderThread::SetRenderingThreadConfig(threads_config.render_thread);
+
+        thread::ThreadPoolConfig pool_config;
+        pool_config.num_threads   = threads_config.worker_count;
+        pool_config.worker_config = threads_config.worker_threads;
+        pool_config.pin_workers   = threads_config.pin_workers;
+        thread::ThreadPool::ConfigureDefaultPool(pool_config);
+    }
+
+    void Engine::SetThreadsConfig(const thread::EngineThreadsConfig& threads_config)
+    {
+        if (s_is_initialized)
+        {
+            BRR_LogWarn("Engine is already initialized. Ignoring new threads configuration.");
+            return;
+        }
+        s_threads_config = threads_config;
+    }
+
     void Engine::InitEngine()
     {
         LogSystem::SetPattern("[%Y-%m-%d %T.%e] [%^%l%$] [%!] [%s:%#]\n%v\n");
+        ConfigureEngineThreads(s_threads_config);
         s_window_manager.reset(new vis::WindowManager(800, 600));
         s_input_system.reset(new InputSystem());
         s_main_scene.reset(new Scene());
@@ -68,6 +123,9 @@ namespace brr
         if (s_window_manager->IsMainWindowClosed())
 				return;
 
+        // Resume work scheduled to the main thread (e.g. coroutines waiting for the next frame) before updating the scene.
+        thread::MainThread::RunMain(MAIN_THREAD_TASKS_TIME_BUDGET);
+
         s_main_scene->Update();
 
         // imgui new frame
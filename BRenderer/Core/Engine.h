@@ -1,6 +1,8 @@
 #ifndef BRR_ENGINE_H
 #define BRR_ENGINE_H
 
+#include <Core/Threading/ThreadConfig.h>
+
 namespace brr
 {
     namespace vis
@@ -16,6 +18,10 @@ namespace brr
 
         static bool IsInitialized();
 
+        // Set the configuration of the engine threads (main, render and ThreadPool workers).
+        // Must be called before the engine is initialized.
+        static void SetThreadsConfig(const thread::EngineThreadsConfig& threads_config);
+
         static vis::WindowManager* GetWindowManager();
 
         static InputSystem* GetInputSystem();
@@ -2,22 +2,43 @@
 #define BRR_DYNAMICPOOL_H
 #include <Core/LogSystem.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include <vector>
-#include <unordered_map>
 
 namespace brr
 {
+    /**
+     * \brief Default key index of ContiguousPool. Integer and enum keys are used directly as indices.
+     */
+    template<typename KeyType>
+    struct ContiguousPoolKeyIndex
+    {
+        static_assert(std::is_integral_v<KeyType> || std::is_enum_v<KeyType>,
+                      "ContiguousPool keys that are not integers or enums require a custom KeyIndex.");
+
+        constexpr size_t operator()(KeyType key) const noexcept { return static_cast<size_t>(key); }
+    };
+
     /**
      * \brief Templated dynamic pool that stores all its objects in contiguous memory.
      *        Since all active objects are stored in contiguous memory, iterating through the pool is very fast.
-     *        Creating a new object generates a new ObjectId, which is unique per pool instance.
-     *        Accessing an individual object involves an indirect memory access
-     *        using the ObjectId identifier to obtain the object index.
-     *        That means accessing elements this way is not the fastest way.
+     *
+     *        The pool is a sparse set. Each key is converted to an index with 'KeyIndex', which is used to access
+     *        a sparse array that stores the position of the object in the dense array. The dense array of keys is
+     *        used to validate lookups and to update the sparse array when objects are moved by a removal.
+     *        Add, Get, Contains and RemoveObject are O(1) and don't hash the keys.
+     *
+     *        The sparse array is allocated in pages, so keys should be dense integer IDs (e.g. generated by an IDGenerator
+     *        or slot indices of a ResourceAllocator) to keep its memory usage low.
+     * \tparam KeyIndex Callable that returns the sparse index of a key. Keys with the same index and different values
+     *         (e.g. ResourceHandles with the same slot and different validation) can't be in the pool at the same time.
      */
-    template<typename KeyType, typename T, class Hasher = std::hash<KeyType>>
+    template<typename KeyType, typename T, class KeyIndex = ContiguousPoolKeyIndex<KeyType>>
     class ContiguousPool
     {
     public:
@@ -40,10 +61,15 @@ namespace brr
 
         void Clear();
 
-        [[nodiscard]] bool Contains(KeyType object_key) const { return m_object_index_map.contains(object_key); }
+        [[nodiscard]] bool Contains(KeyType object_key) const { return GetDenseIndex(object_key) != INVALID_INDEX; }
 
         [[nodiscard]] size_t Size() const { return m_active_count; }
 
+        /**
+         * \brief Get the key of the object stored at 'index' of the contiguous memory.
+         */
+        [[nodiscard]] const KeyType& GetKey(uint32_t index) const { assert(index < m_active_count); return m_dense_keys[index]; }
+
         T* Data() { return m_pool.data(); }
 
         iterator begin();
@@ -53,36 +79,50 @@ namespace brr
         const_iterator cend();
 
     private:
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t SPARSE_PAGE_SIZE = 4096;
+
+        uint32_t GetDenseIndex(const KeyType& object_key) const;
+
+        /**
+         * \brief Get the sparse array entry of 'object_key', allocating its page if needed.
+         */
+        uint32_t& GetSparseEntry(const KeyType& object_key);
 
-        std::unordered_map<KeyType, uint32_t, Hasher> m_object_index_map;
+        std::vector<std::unique_ptr<uint32_t[]>> m_sparse_pages;
+        std::vector<KeyType> m_dense_keys;
         std::vector<T> m_pool;
         uint32_t m_active_count;
     };
 
-    template<typename KeyType, typename T, class Hasher>
-    ContiguousPool<KeyType, T, Hasher>::ContiguousPool(uint32_t initial_size)
+    template<typename KeyType, typename T, class KeyIndex>
+    ContiguousPool<KeyType, T, KeyIndex>::ContiguousPool(uint32_t initial_size)
     : m_pool(initial_size),
       m_active_count(0)
     {
+        m_dense_keys.reserve(initial_size);
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    ContiguousPool<KeyType, T, Hasher>::ContiguousPool(const T& initial_value, uint32_t initial_size)
+    template<typename KeyType, typename T, class KeyIndex>
+    ContiguousPool<KeyType, T, KeyIndex>::ContiguousPool(const T& initial_value, uint32_t initial_size)
     : m_pool(initial_size, initial_value),
       m_active_count(0)
     {
+        m_dense_keys.reserve(initial_size);
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    bool ContiguousPool<KeyType, T, Hasher>::AddObject(KeyType object_key, const T& value)
+    template<typename KeyType, typename T, class KeyIndex>
+    bool ContiguousPool<KeyType, T, KeyIndex>::AddObject(KeyType object_key, const T& value)
     {
-        if (m_object_index_map.contains(object_key))
+        uint32_t& sparse_entry = GetSparseEntry(object_key);
+        if (sparse_entry != INVALID_INDEX)
         {
             BRR_LogError("Can't add object (ID: {}) to pool. Object with this ID already exists.", uint64_t(object_key));
             return false;
         }
-        
-        m_object_index_map.emplace(object_key, m_active_count);
+
+        sparse_entry = m_active_count;
+        m_dense_keys.push_back(object_key);
         if (m_active_count == m_pool.size())
         {
             m_pool.push_back(value);
@@ -95,16 +135,18 @@ namespace brr
         return true;
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    bool ContiguousPool<KeyType, T, Hasher>::AddObject(KeyType object_key, T&& value)
+    template<typename KeyType, typename T, class KeyIndex>
+    bool ContiguousPool<KeyType, T, KeyIndex>::AddObject(KeyType object_key, T&& value)
     {
-        if (m_object_index_map.contains(object_key))
+        uint32_t& sparse_entry = GetSparseEntry(object_key);
+        if (sparse_entry != INVALID_INDEX)
         {
             BRR_LogError("Can't add object (ID: {}) to pool. Object with this ID already exists.", uint64_t(object_key));
             return false;
         }
 
-        m_object_index_map.emplace(object_key, m_active_count);
+        sparse_entry = m_active_count;
+        m_dense_keys.push_back(object_key);
         if (m_active_count == m_pool.size())
         {
             m_pool.push_back(std::move(value));
@@ -117,100 +159,140 @@ namespace brr
         return true;
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    T& ContiguousPool<KeyType, T, Hasher>::Get(KeyType object_key)
+    template<typename KeyType, typename T, class KeyIndex>
+    T& ContiguousPool<KeyType, T, KeyIndex>::Get(KeyType object_key)
     {
-        assert(m_object_index_map.contains(object_key) && "Need to pass valid ObjectId. Passed ObjectId does not exist is this ContiguousPool.");
+        const uint32_t index = GetDenseIndex(object_key);
+        assert(index != INVALID_INDEX && "Need to pass valid ObjectId. Passed ObjectId does not exist is this ContiguousPool.");
 
-        uint32_t index = m_object_index_map.at(object_key);
-        return m_pool.at(index);
+        return m_pool[index];
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    const T& ContiguousPool<KeyType, T, Hasher>::Get(KeyType object_key) const
+    template<typename KeyType, typename T, class KeyIndex>
+    const T& ContiguousPool<KeyType, T, KeyIndex>::Get(KeyType object_key) const
     {
-        assert(m_object_index_map.contains(object_key) && "Need to pass valid ObjectId. Passed ObjectId does not exist is this ContiguousPool.");
+        const uint32_t index = GetDenseIndex(object_key);
+        assert(index != INVALID_INDEX && "Need to pass valid ObjectId. Passed ObjectId does not exist is this ContiguousPool.");
 
-        uint32_t index = m_object_index_map.at(object_key);
-        return m_pool.at(index);
+        return m_pool[index];
     }
 
-    template <typename KeyType, typename T, class Hasher>
-    typename ContiguousPool<KeyType, T, Hasher>::iterator ContiguousPool<KeyType, T, Hasher>::Find(KeyType object_key)
+    template <typename KeyType, typename T, class KeyIndex>
+    typename ContiguousPool<KeyType, T, KeyIndex>::iterator ContiguousPool<KeyType, T, KeyIndex>::Find(KeyType object_key)
     {
-        auto iter = m_object_index_map.find(object_key);
-        if (iter == m_object_index_map.end())
+        const uint32_t index = GetDenseIndex(object_key);
+        if (index == INVALID_INDEX)
         {
             return end();
         }
 
-        return m_pool.begin() + iter->second;
+        return m_pool.begin() + index;
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    void ContiguousPool<KeyType, T, Hasher>::RemoveObject(KeyType object_key)
+    template<typename KeyType, typename T, class KeyIndex>
+    void ContiguousPool<KeyType, T, KeyIndex>::RemoveObject(KeyType object_key)
     {
-        if (!m_object_index_map.contains(object_key))
+        const uint32_t index = GetDenseIndex(object_key);
+        if (index == INVALID_INDEX)
         {
             BRR_LogError("Need to pass valid ObjectId. Passed ObjectId '{}' does not exist is this ContiguousPool.", uint64_t(object_key));
             return;
         }
 
+        assert(index < m_active_count && "Invalid index. something is wrong.");
+
         const uint32_t last_index = m_active_count - 1;
-        const uint32_t index = m_object_index_map.at(object_key);
-        m_object_index_map.erase(object_key);
+        GetSparseEntry(object_key) = INVALID_INDEX;
 
-        assert(index < m_active_count && "Invalid index. something is wrong.");
-        
         m_active_count--;
         if (index == last_index)
         {
+            m_dense_keys.pop_back();
             T removed_value = std::move(m_pool[index]);
             return;
         }
 
+        // Move the last object to the removed position, and point its key to the new position.
         m_pool[index] = std::move(m_pool[last_index]);
-        for (auto& iter : m_object_index_map)
-        {
-            if (iter.second == last_index)
-            {
-                m_object_index_map[iter.first] = index;
-                break;
-            }
-        }
+        m_dense_keys[index] = m_dense_keys[last_index];
+        m_dense_keys.pop_back();
+        GetSparseEntry(m_dense_keys[index]) = index;
     }
 
-    template <typename KeyType, typename T, class Hasher>
-    void ContiguousPool<KeyType, T, Hasher>::Clear()
+    template <typename KeyType, typename T, class KeyIndex>
+    void ContiguousPool<KeyType, T, KeyIndex>::Clear()
     {
+        // Only the entries of active keys are reset, so the sparse pages are reused.
+        for (const KeyType& object_key : m_dense_keys)
+        {
+            GetSparseEntry(object_key) = INVALID_INDEX;
+        }
+        m_dense_keys.clear();
         m_pool.clear();
-        m_object_index_map.clear();
         m_active_count = 0;
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    typename ContiguousPool<KeyType, T, Hasher>::iterator ContiguousPool<KeyType, T, Hasher>::begin()
+    template<typename KeyType, typename T, class KeyIndex>
+    typename ContiguousPool<KeyType, T, KeyIndex>::iterator ContiguousPool<KeyType, T, KeyIndex>::begin()
     {
         return m_pool.begin();
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    typename ContiguousPool<KeyType, T, Hasher>::iterator ContiguousPool<KeyType, T, Hasher>::end()
+    template<typename KeyType, typename T, class KeyIndex>
+    typename ContiguousPool<KeyType, T, KeyIndex>::iterator ContiguousPool<KeyType, T, KeyIndex>::end()
     {
         return m_pool.begin() + m_active_count;
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    typename ContiguousPool<KeyType, T, Hasher>::const_iterator ContiguousPool<KeyType, T, Hasher>::cbegin()
+    template<typename KeyType, typename T, class KeyIndex>
+    typename ContiguousPool<KeyType, T, KeyIndex>::const_iterator ContiguousPool<KeyType, T, KeyIndex>::cbegin()
     {
         return m_pool.cbegin();
     }
 
-    template<typename KeyType, typename T, class Hasher>
-    typename ContiguousPool<KeyType, T, Hasher>::const_iterator ContiguousPool<KeyType, T, Hasher>::cend()
+    template<typename KeyType, typename T, class KeyIndex>
+    typename ContiguousPool<KeyType, T, KeyIndex>::const_iterator ContiguousPool<KeyType, T, KeyIndex>::cend()
     {
         return m_pool.cbegin() + m_active_count;
     }
+
+    template<typename KeyType, typename T, class KeyIndex>
+    uint32_t ContiguousPool<KeyType, T, KeyIndex>::GetDenseIndex(const KeyType& object_key) const
+    {
+        const size_t sparse_index = KeyIndex{}(object_key);
+        const size_t page_index = sparse_index / SPARSE_PAGE_SIZE;
+        if (page_index >= m_sparse_pages.size() || !m_sparse_pages[page_index])
+        {
+            return INVALID_INDEX;
+        }
+
+        const uint32_t dense_index = m_sparse_pages[page_index][sparse_index % SPARSE_PAGE_SIZE];
+        // Keys that share the same sparse index (e.g. stale ResourceHandles) are rejected by comparing the stored key.
+        if (dense_index == INVALID_INDEX || !(m_dense_keys[dense_index] == object_key))
+        {
+            return INVALID_INDEX;
+        }
+        return dense_index;
+    }
+
+    template<typename KeyType, typename T, class KeyIndex>
+    uint32_t& ContiguousPool<KeyType, T, KeyIndex>::GetSparseEntry(const KeyType& object_key)
+    {
+        const size_t sparse_index = KeyIndex{}(object_key);
+        const size_t page_index = sparse_index / SPARSE_PAGE_SIZE;
+        if (page_index >= m_sparse_pages.size())
+        {
+            m_sparse_pages.resize(page_index + 1);
+        }
+
+        std::unique_ptr<uint32_t[]>& page = m_sparse_pages[page_index];
+        if (!page)
+        {
+            page = std::make_unique_for_overwrite<uint32_t[]>(SPARSE_PAGE_SIZE);
+            std::fill_n(page.get(), SPARSE_PAGE_SIZE, INVALID_INDEX);
+        }
+        return page[sparse_index % SPARSE_PAGE_SIZE];
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
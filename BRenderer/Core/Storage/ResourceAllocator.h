@@ -1,31 +1,61 @@
 #ifndef BRR_RESOURCEALLOCATOR_H
 #define BRR_RESOURCEALLOCATOR_H
-#include <ranges>
 #include <Core/LogSystem.h>
 
-#include <set>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <new>
+
+#ifndef BRR_RESOURCE_HANDLE_INDEX_BITS
+// Number of bits of a ResourceHandle used by the slot index. The remaining bits store the slot generation.
+#define BRR_RESOURCE_HANDLE_INDEX_BITS 32
+#endif
+
+#ifndef BRR_DEBUG_RESOURCE_HANDLES
+// Report uses of stale and invalid handles in ResourceAllocator. Enabled by default on debug builds.
+#ifdef NDEBUG
+#define BRR_DEBUG_RESOURCE_HANDLES 0
+#else
+#define BRR_DEBUG_RESOURCE_HANDLES 1
+#endif
+#endif
 
 namespace brr
 {
     template<typename T>
     class ResourceAllocator;
 
+    struct ResourceHandleIndex;
+
+    /**
+     * \brief Handle of a resource owned by a ResourceAllocator.
+     *
+     * Packed in 64 bits: the slot index is stored in the lowest 'INDEX_BITS' bits, and the slot generation in the
+     * remaining bits. The widths are configured with 'BRR_RESOURCE_HANDLE_INDEX_BITS'.
+     */
     struct ResourceHandle
     {
+        static constexpr uint32_t INDEX_BITS      = BRR_RESOURCE_HANDLE_INDEX_BITS;
+        static constexpr uint32_t GENERATION_BITS = 64 - INDEX_BITS;
+        static constexpr uint64_t INDEX_MASK      = (uint64_t(1) << INDEX_BITS) - 1;
+        static constexpr uint64_t GENERATION_MASK = std::numeric_limits<uint64_t>::max() >> INDEX_BITS;
 
-        constexpr ResourceHandle() : index(std::numeric_limits<uint32_t>::max()), validation(std::numeric_limits<uint32_t>::max())
+        static_assert(INDEX_BITS >= 8 && INDEX_BITS <= 32, "BRR_RESOURCE_HANDLE_INDEX_BITS must be between 8 and 32.");
+
+        constexpr ResourceHandle() : value(std::numeric_limits<uint64_t>::max())
         {}
 
-        explicit ResourceHandle(uint64_t handle_value)
-        {
-            index = static_cast<uint32_t>(handle_value & 0xFFFFFFFF);
-            validation = static_cast<uint32_t>((handle_value >> 32) & 0xFFFFFFFF);
-        }
+        explicit constexpr ResourceHandle(uint64_t handle_value) : value(handle_value)
+        {}
 
         constexpr bool operator ==(const ResourceHandle& other) const
         {
-            return index == other.index && validation == other.validation;
+            return value == other.value;
         }
 
         constexpr bool IsValid() const
@@ -40,25 +70,61 @@ namespace brr
 
         constexpr operator uint64_t() const
         {
-            return (static_cast<uint64_t>(validation) << 32) | index;
+            return value;
         }
 
     protected:
 
         template<typename T> friend class ResourceAllocator;
-        friend struct std::hash<ResourceHandle>;
+        friend struct ResourceHandleIndex;
 
-        uint32_t index;
-        uint32_t validation;
+        constexpr ResourceHandle(uint32_t index, uint64_t generation)
+        : value(((generation & GENERATION_MASK) << INDEX_BITS) | index)
+        {}
+
+        constexpr uint32_t GetIndex() const { return static_cast<uint32_t>(value & INDEX_MASK); }
+        constexpr uint64_t GetGeneration() const { return value >> INDEX_BITS; }
+
+        uint64_t value;
+    };
+
+    /**
+     * \brief Returns the slot index of a ResourceHandle. Used as key index of ContiguousPool, since slot indices are dense.
+     */
+    struct ResourceHandleIndex
+    {
+        constexpr size_t operator()(const ResourceHandle& handle) const noexcept { return handle.GetIndex(); }
     };
     static constexpr ResourceHandle null_handle = ResourceHandle{};
 
+    namespace detail
+    {
+        /**
+         * \brief Index of the calling thread, used to pick a ResourceAllocator thread cache.
+         */
+        inline uint32_t GetResourceAllocatorThreadIndex()
+        {
+            static std::atomic<uint32_t> s_next_thread_index = 0;
+            thread_local const uint32_t t_thread_index = s_next_thread_index.fetch_add(1, std::memory_order_relaxed);
+            return t_thread_index;
+        }
+    }
+
     /**
      * \brief ResourceAllocator is a thread-safe, template allocator for storing resources.
      *
      * When creating a resource, a ResourceHandle is returned to represent the new resource.
      * The resource's pointer (T*) can be obtained using the ResourceHandle.
      * A resource's pointer remains valid until the resource is destroyed.
+     *
+     * Resources are stored in chunks that are never moved or freed while the allocator exists. Each slot has an atomic
+     * generation, incremented when its resource is destroyed, so handles to destroyed resources don't match the slot
+     * anymore. 'GetResource' and 'OwnsResource' only compare generations and don't take any lock.
+     * Free slots form an intrusive list. Allocations and destructions go through small per-thread caches of free
+     * slots, and only take the allocator-wide lock to move batches of slots from/to the shared free list.
+     *
+     * When BRR_DEBUG_RESOURCE_HANDLES is enabled, using a stale or invalid handle to get, initialize or destroy a
+     * resource is logged and counted. The check itself (OwnsResource) never logs.
      * \tparam T Resource type managed by the ResourceAllocator
      */
     template<typename T>
@@ -72,6 +138,11 @@ namespace brr
          */
         ResourceAllocator(size_t chunk_size = 65536);
 
+        ResourceAllocator(const ResourceAllocator&) = delete;
+        ResourceAllocator& operator=(const ResourceAllocator&) = delete;
+
+        ~ResourceAllocator();
+
         /**
          * Allocate a resource but don't initialize it.
          * @return handle for uninitialized allocated resource
@@ -106,103 +177,174 @@ namespace brr
         bool DestroyResource(const ResourceHandle& handle);
 
         /**
-         * Get a pointer to the resource owned by the passed handle.
+         * Get a pointer to the resource owned by the passed handle. Doesn't take any lock.
          * @param handle Resource handle.
          * @return Resource pointer. `nullptr` if handle is not valid.
          */
         T* GetResource(const ResourceHandle& handle) const;
 
         /**
-         * Check if allocator owns resource.
+         * Check if allocator owns resource. Doesn't take any lock.
          * @param handle Resource handle.
          * @return `true` if allocator owns resource with the passed handle. `false` otherwise.
          */
         bool OwnsResource(const ResourceHandle& handle) const;
 
+#if BRR_DEBUG_RESOURCE_HANDLES
+        /**
+         * Number of times a stale or invalid handle was used to get, initialize or destroy a resource.
+         */
+        [[nodiscard]] size_t InvalidHandleUsesCount() const { return m_invalid_handle_uses.load(std::memory_order_relaxed); }
+#endif
+
     private:
-        static constexpr size_t TypeSize = sizeof(T);
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+        // Largest slot index. The index of the null handle is never allocated.
+        static constexpr uint64_t MAX_ELEMENTS = ResourceHandle::INDEX_MASK;
 
-        ResourceHandle _AllocateResource();
+        // Chunk pointers are stored in a fixed directory, so readers never see it reallocating.
+        static constexpr size_t MAX_CHUNKS = 4096;
+        static constexpr size_t MIN_ELEMENTS_IN_CHUNK = 64;
 
-        template <typename... Args>
-        T* _InitializeResource(const ResourceHandle& handle, Args&&... args);
+        static constexpr size_t THREAD_CACHES_COUNT = 16;
+        // Number of free slots moved at once between a thread cache and the shared free list.
+        static constexpr uint32_t CACHE_BATCH_SIZE = 32;
+        static constexpr uint32_t CACHE_MAX_SIZE = CACHE_BATCH_SIZE * 2;
+
+        struct Slot
+        {
+            // Generation of the resource in this slot. Incremented when the resource is destroyed.
+            std::atomic<uint64_t> generation { 0 };
+            // Next slot in the free list this slot belongs to.
+            uint32_t next_free = INVALID_INDEX;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* Resource() { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        struct alignas(64) ThreadCache
+        {
+            std::mutex mutex;
+            uint32_t free_head = INVALID_INDEX;
+            uint32_t free_count = 0;
+        };
+
+        Slot& GetSlot(uint32_t index) const;
+
+        ThreadCache& GetThreadCache();
+
+        /**
+         * \brief Move a batch of free slots from the shared free list to the cache, allocating a new chunk if needed.
+         * Called with the cache mutex locked.
+         */
+        void RefillCache(ThreadCache& cache);
+
+        /**
+         * \brief Move a batch of free slots from the cache back to the shared free list.
+         * Called with the cache mutex locked.
+         */
+        void FlushCache(ThreadCache& cache);
+
+        /**
+         * \brief Allocate a new chunk and push its slots to the shared free list. Called with 'm_mutex' locked.
+         */
+        bool AllocateChunk();
 
         bool OwnsHandle(const ResourceHandle& handle) const;
 
-        static constexpr uint32_t INVALID_BIT = 0x80000000;
+#if BRR_DEBUG_RESOURCE_HANDLES
+        void ReportInvalidHandle(const ResourceHandle& handle) const;
+
+        mutable std::atomic<size_t> m_invalid_handle_uses {0};
+#endif
 
-        std::vector<T*> m_chunks;
-        std::vector<uint32_t> m_validation;
-        std::set<uint32_t> m_free_set;
-        uint32_t m_allocated_elements;
+        std::unique_ptr<std::atomic<Slot*>[]> m_chunks;
+        std::atomic<uint32_t> m_allocated_elements;
         const uint32_t m_elements_in_chunk;
-        mutable std::mutex m_mutex;
+
+        std::array<ThreadCache, THREAD_CACHES_COUNT> m_thread_caches {};
+
+        // Shared free list. Guarded by 'm_mutex', which also guards chunk allocation.
+        std::mutex m_mutex;
+        uint32_t m_free_head = INVALID_INDEX;
     };
 
     /******************
      * Implementation *
      ******************/
 
-    namespace
+    template <typename T>
+    ResourceAllocator<T>::ResourceAllocator(size_t chunk_size)
+    : m_chunks(std::make_unique<std::atomic<Slot*>[]>(MAX_CHUNKS)),
+      m_allocated_elements(0),
+      m_elements_in_chunk(static_cast<uint32_t>(std::max(chunk_size / sizeof(Slot), MIN_ELEMENTS_IN_CHUNK)))
     {
-        class ValidatorGen
-        {
-        public:
-            static uint32_t GetNextValidation()
-            {
-                return curr_validation++;
-            }
-
-        private:
-            static std::atomic<uint32_t> curr_validation;
-        };
-
-        std::atomic<uint32_t> ValidatorGen::curr_validation = 0;
+        std::lock_guard lock_guard (m_mutex);
+        AllocateChunk();
     }
 
     template <typename T>
-    ResourceAllocator<T>::ResourceAllocator(size_t chunk_size)
-    : m_elements_in_chunk(sizeof(T) > chunk_size ? 1 : chunk_size / sizeof(T))
+    ResourceAllocator<T>::~ResourceAllocator()
     {
-        
-        std::allocator<T> allocator;
-        T* first_chunk = allocator.allocate(m_elements_in_chunk * sizeof(T));
-        m_chunks.push_back(first_chunk);
-
-        auto new_range = std::ranges::iota_view{0u, m_elements_in_chunk};
-        m_free_set.insert(new_range.begin(), new_range.end());
-
-        m_validation = std::vector<uint32_t> (m_elements_in_chunk, INVALID_BIT);
-        m_allocated_elements = m_elements_in_chunk;
+        // Resources that were not destroyed are not destructed, only their memory is released.
+        const uint32_t chunks_count = m_allocated_elements.load(std::memory_order_acquire) / m_elements_in_chunk;
+        for (uint32_t chunk_idx = 0; chunk_idx < chunks_count; ++chunk_idx)
+        {
+            delete[] m_chunks[chunk_idx].load(std::memory_order_relaxed);
+        }
     }
 
     template <typename T>
     ResourceHandle ResourceAllocator<T>::AllocateResource()
     {
-        std::lock_guard lock_guard (m_mutex);
-        return _AllocateResource();
+        ThreadCache& cache = GetThreadCache();
+
+        uint32_t free_idx;
+        {
+            std::lock_guard cache_lock (cache.mutex);
+            if (cache.free_head == INVALID_INDEX)
+            {
+                RefillCache(cache);
+                if (cache.free_head == INVALID_INDEX)
+                {
+                    return null_handle;
+                }
+            }
+
+            free_idx = cache.free_head;
+            cache.free_head = GetSlot(free_idx).next_free;
+            cache.free_count--;
+        }
+
+        // The generation was already incremented when the previous resource of this slot was destroyed.
+        return ResourceHandle(free_idx, GetSlot(free_idx).generation.load(std::memory_order_relaxed));
     }
 
     template <typename T>
     template <typename ... Args>
     T* ResourceAllocator<T>::InitializeResource(const ResourceHandle& handle, Args&&... args)
     {
-        std::lock_guard lock_guard (m_mutex);
-        if (!OwnsHandle(handle))
+        if (!OwnsHandle(handle)) [[unlikely]]
         {
+#if BRR_DEBUG_RESOURCE_HANDLES
+            ReportInvalidHandle(handle);
+#endif
             return nullptr;
         }
-        return _InitializeResource(handle, std::forward<Args>(args)...);
+        return std::construct_at(GetSlot(handle.GetIndex()).Resource(), std::forward<Args>(args)...);
     }
 
     template <typename T>
     template <typename... Args>
     ResourceHandle ResourceAllocator<T>::CreateResource(T** new_resource_ref, Args&&... args)
     {
-        std::lock_guard lock_guard (m_mutex);
-        ResourceHandle handle = _AllocateResource();
+        ResourceHandle handle = AllocateResource();
+        if (!handle)
+        {
+            return handle;
+        }
 
-        T* resource = _InitializeResource(handle, std::forward<Args>(args)...);
+        T* resource = std::construct_at(GetSlot(handle.GetIndex()).Resource(), std::forward<Args>(args)...);
         if (new_resource_ref)
         {
             *new_resource_ref = resource;
@@ -214,21 +356,36 @@ namespace brr
     template <typename T>
     bool ResourceAllocator<T>::DestroyResource(const ResourceHandle& handle)
     {
-        std::lock_guard lock_guard (m_mutex);
-        if (!OwnsHandle(handle))
+        if (!OwnsHandle(handle)) [[unlikely]]
         {
+#if BRR_DEBUG_RESOURCE_HANDLES
+            ReportInvalidHandle(handle);
+#endif
             return false;
         }
 
-        m_free_set.emplace(handle.index);
-        m_validation[handle.index] |= INVALID_BIT;
+        Slot& slot = GetSlot(handle.GetIndex());
+        // Incrementing the generation invalidates every handle to this resource. Only one thread can increment it,
+        // so concurrent destructions of the same handle are safe.
+        uint64_t expected_generation = handle.GetGeneration();
+        const uint64_t next_generation = (expected_generation + 1) & ResourceHandle::GENERATION_MASK;
+        if (!slot.generation.compare_exchange_strong(expected_generation, next_generation, std::memory_order_acq_rel))
+        {
+            return false;
+        }
 
         if constexpr (!std::is_trivial_v<T> && std::is_destructible_v<T>)
         {
-            const uint32_t chunk_idx = handle.index / m_elements_in_chunk;
-            const uint32_t element_idx = handle.index % m_elements_in_chunk;
-            T* resource = m_chunks[chunk_idx] + element_idx;
-            std::destroy_at(resource);
+            std::destroy_at(slot.Resource());
+        }
+
+        ThreadCache& cache = GetThreadCache();
+        std::lock_guard cache_lock (cache.mutex);
+        slot.next_free = cache.free_head;
+        cache.free_head = handle.GetIndex();
+        if (++cache.free_count > CACHE_MAX_SIZE)
+        {
+            FlushCache(cache);
         }
 
         return true;
@@ -237,96 +394,135 @@ namespace brr
     template <typename T>
     T* ResourceAllocator<T>::GetResource(const ResourceHandle& handle) const
     {
-        std::lock_guard lock_guard (m_mutex);
-        if (!OwnsHandle(handle))
+        if (!OwnsHandle(handle)) [[unlikely]]
         {
+#if BRR_DEBUG_RESOURCE_HANDLES
+            ReportInvalidHandle(handle);
+#endif
             return nullptr;
         }
 
-        const uint32_t chunk_idx = handle.index / m_elements_in_chunk;
-        const uint32_t element_idx = handle.index % m_elements_in_chunk;
-
-        return m_chunks[chunk_idx] + element_idx;
+        return GetSlot(handle.GetIndex()).Resource();
     }
 
     template <typename T>
     bool ResourceAllocator<T>::OwnsResource(const ResourceHandle& handle) const
     {
-        std::lock_guard lock_guard (m_mutex);
         return OwnsHandle(handle);
     }
 
     template <typename T>
-    ResourceHandle ResourceAllocator<T>::_AllocateResource()
+    typename ResourceAllocator<T>::Slot& ResourceAllocator<T>::GetSlot(uint32_t index) const
     {
-        ResourceHandle handle;
-
-        if (m_free_set.empty())
-        {
-            uint32_t previous_size = m_allocated_elements;
-
-            std::allocator<T> allocator;
-            T* new_chunk = allocator.allocate(m_elements_in_chunk * sizeof(T));
-            m_chunks.push_back(new_chunk);
-            m_allocated_elements += m_elements_in_chunk;
+        Slot* chunk = m_chunks[index / m_elements_in_chunk].load(std::memory_order_acquire);
+        return chunk[index % m_elements_in_chunk];
+    }
 
-            auto new_range = std::ranges::iota_view{previous_size, m_allocated_elements};
-            m_free_set.insert(new_range.begin(), new_range.end());
+    template <typename T>
+    typename ResourceAllocator<T>::ThreadCache& ResourceAllocator<T>::GetThreadCache()
+    {
+        return m_thread_caches[detail::GetResourceAllocatorThreadIndex() % THREAD_CACHES_COUNT];
+    }
 
-            m_validation.resize(m_allocated_elements, INVALID_BIT);
+    template <typename T>
+    void ResourceAllocator<T>::RefillCache(ThreadCache& cache)
+    {
+        std::lock_guard lock_guard (m_mutex);
+        if (m_free_head == INVALID_INDEX && !AllocateChunk())
+        {
+            return;
         }
 
-        const uint32_t free_idx = *(m_free_set.begin());
-        m_free_set.erase(m_free_set.begin());
+        while (m_free_head != INVALID_INDEX && cache.free_count < CACHE_BATCH_SIZE)
+        {
+            const uint32_t free_idx = m_free_head;
+            Slot& slot = GetSlot(free_idx);
+            m_free_head = slot.next_free;
 
-        handle.index = free_idx;
+            slot.next_free = cache.free_head;
+            cache.free_head = free_idx;
+            cache.free_count++;
+        }
+    }
 
-        handle.validation = m_validation[free_idx] = ValidatorGen::GetNextValidation();
-        assert((handle.validation & INVALID_BIT) == 0 && "Validation value can't contain INVALID_BIT");
+    template <typename T>
+    void ResourceAllocator<T>::FlushCache(ThreadCache& cache)
+    {
+        std::lock_guard lock_guard (m_mutex);
+        while (cache.free_count > CACHE_BATCH_SIZE)
+        {
+            const uint32_t free_idx = cache.free_head;
+            Slot& slot = GetSlot(free_idx);
+            cache.free_head = slot.next_free;
+            cache.free_count--;
 
-        return handle;
+            slot.next_free = m_free_head;
+            m_free_head = free_idx;
+        }
     }
 
     template <typename T>
-    template <typename ... Args>
-    T* ResourceAllocator<T>::_InitializeResource(const ResourceHandle& handle, Args&&... args)
+    bool ResourceAllocator<T>::AllocateChunk()
     {
-        const uint32_t chunk_idx = handle.index / m_elements_in_chunk;
-        const uint32_t element_idx = handle.index % m_elements_in_chunk;
+        const uint32_t previous_size = m_allocated_elements.load(std::memory_order_relaxed);
+        const uint32_t chunk_idx = previous_size / m_elements_in_chunk;
+        if (chunk_idx >= MAX_CHUNKS || previous_size + m_elements_in_chunk > MAX_ELEMENTS)
+        {
+            BRR_LogError("ResourceAllocator is full. Can't allocate more than {} resources.", previous_size);
+            return false;
+        }
 
-        T* resource = m_chunks[chunk_idx] + element_idx;
-        std::construct_at(resource, std::forward<Args>(args)...);
+        Slot* new_chunk = new Slot[m_elements_in_chunk];
+        // Slots are pushed in reverse order, so they are allocated in increasing index order.
+        for (uint32_t element_idx = m_elements_in_chunk; element_idx > 0; --element_idx)
+        {
+            new_chunk[element_idx - 1].next_free = m_free_head;
+            m_free_head = previous_size + element_idx - 1;
+        }
 
-        return resource;
+        // The chunk is published before the new size, so readers that see an index as allocated also see its chunk.
+        m_chunks[chunk_idx].store(new_chunk, std::memory_order_release);
+        m_allocated_elements.store(previous_size + m_elements_in_chunk, std::memory_order_release);
+        return true;
     }
 
     template <typename T>
     bool ResourceAllocator<T>::OwnsHandle(const ResourceHandle& handle) const
     {
-        if (handle.index >= m_allocated_elements)
+        // Hot path of every lookup. Invalid handles are reported by the callers, only on debug builds.
+        const uint32_t index = handle.GetIndex();
+        if (index >= m_allocated_elements.load(std::memory_order_acquire))
         {
-            BRR_LogTrace(
-                "Error: Invalid resource handle. Index points to non-existent resource.\n\tHandle index:\t{}\n\tResources count:\t{}",
-                handle.index, m_current_buffer_size);
             return false;
         }
+        return GetSlot(index).generation.load(std::memory_order_acquire) == handle.GetGeneration();
+    }
 
-        if (handle.validation & INVALID_BIT)
+#if BRR_DEBUG_RESOURCE_HANDLES
+    template <typename T>
+    void ResourceAllocator<T>::ReportInvalidHandle(const ResourceHandle& handle) const
+    {
+        // Null handles are used to represent missing resources, so they are not reported.
+        if (!handle)
         {
-            BRR_LogTrace("Error: Invalid handle. Handle References a deleted resource.");
-            return false;
+            return;
         }
 
-        if (handle.validation != m_validation[handle.index])
+        m_invalid_handle_uses.fetch_add(1, std::memory_order_relaxed);
+
+        const uint32_t index = handle.GetIndex();
+        const uint32_t allocated_elements = m_allocated_elements.load(std::memory_order_acquire);
+        if (index >= allocated_elements)
         {
-            BRR_LogTrace(
-                "Error: Invalid handle. Handle validation does not match.\n\tHandle validation:\t{}\n\tResource validation\t{}",
-                handle.validation, m_validation[handle.index]);
-            return false;
+            BRR_LogWarn("Invalid resource handle. Index points to non-existent resource.\n\tHandle index:\t{}\n\tResources count:\t{}",
+                        index, allocated_elements);
+            return;
         }
 
-        return true;
+        BRR_LogWarn("Stale resource handle. Handle references a destroyed resource.\n\tHandle index:\t{}\n\tHandle generation:\t{}\n\tSlot generation:\t{}",
+                    index, handle.GetGeneration(), GetSlot(index).generation.load(std::memory_order_relaxed));
     }
+#endif
 }
 
 template <>
@@ -1,6 +1,7 @@
 #ifndef BRR_Barrier_h
 #define BRR_Barrier_h
 #include <mutex>
+#include <condition_variable>
 
 
 namespace brr::thread
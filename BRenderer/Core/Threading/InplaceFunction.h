@@ -0,0 +1,108 @@
+#ifndef BRR_InplaceFunction_h
+#define BRR_InplaceFunction_h
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace brr::thread
+{
+	/**
+	 * \brief Move-only `void()` callable stored inside a fixed-size buffer. It never allocates memory.
+	 *
+	 * Callables that don't fit in 'Capacity' bytes are rejected at compile time.
+	 * \tparam Capacity Size in bytes of the inline storage.
+	 */
+	template <size_t Capacity>
+	class InplaceFunction
+	{
+	public:
+		InplaceFunction() = default;
+
+		template <typename Func> requires (!std::is_same_v<std::decay_t<Func>, InplaceFunction> && std::is_invocable_r_v<void, std::decay_t<Func>&>)
+		InplaceFunction(Func&& function)
+		{
+			using FuncType = std::decay_t<Func>;
+			static_assert(sizeof(FuncType) <= Capacity, "Callable does not fit in the InplaceFunction storage.");
+			static_assert(alignof(FuncType) <= alignof(std::max_align_t), "Callable alignment is not supported by InplaceFunction.");
+			static_assert(std::is_nothrow_move_constructible_v<FuncType>, "InplaceFunction callables must be nothrow move constructible.");
+
+			new (&m_storage) FuncType(std::forward<Func>(function));
+			m_operations = &s_operations<FuncType>;
+		}
+
+		InplaceFunction(InplaceFunction&& other) noexcept
+		{
+			MoveFrom(other);
+		}
+
+		InplaceFunction& operator=(InplaceFunction&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				MoveFrom(other);
+			}
+			return *this;
+		}
+
+		InplaceFunction(const InplaceFunction&) = delete;
+		InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+		~InplaceFunction()
+		{
+			Reset();
+		}
+
+		void operator()()
+		{
+			m_operations->invoke(&m_storage);
+		}
+
+		explicit operator bool() const { return m_operations != nullptr; }
+
+		void Reset() noexcept
+		{
+			if (m_operations)
+			{
+				m_operations->destroy(&m_storage);
+				m_operations = nullptr;
+			}
+		}
+
+	private:
+		struct Operations
+		{
+			void (*invoke)(void* storage);
+			// Move-construct the callable in 'dst' from 'src' and destroy the one in 'src'.
+			void (*relocate)(void* dst, void* src) noexcept;
+			void (*destroy)(void* storage) noexcept;
+		};
+
+		template <typename FuncType>
+		static constexpr Operations s_operations {
+			[](void* storage) { (*static_cast<FuncType*>(storage))(); },
+			[](void* dst, void* src) noexcept
+			{
+				FuncType* src_func = static_cast<FuncType*>(src);
+				new (dst) FuncType(std::move(*src_func));
+				src_func->~FuncType();
+			},
+			[](void* storage) noexcept { static_cast<FuncType*>(storage)->~FuncType(); }
+		};
+
+		void MoveFrom(InplaceFunction& other) noexcept
+		{
+			if (other.m_operations)
+			{
+				other.m_operations->relocate(&m_storage, &other.m_storage);
+				m_operations = std::exchange(other.m_operations, nullptr);
+			}
+		}
+
+		alignas(std::max_align_t) std::byte m_storage[Capacity];
+		const Operations* m_operations = nullptr;
+	};
+}
+
+#endif
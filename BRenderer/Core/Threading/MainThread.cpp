@@ -1,30 +1,82 @@
 #include "MainThread.h"
 
+#include <rigtorp/MPMCQueue.h>
+
+#include <algorithm>
+#include <deque>
+
 namespace brr::thread
 {
 
-    std::list<MainThread::FunctionType> MainThread::m_main_tasks = {};
-    std::mutex MainThread::m_task_mutex = {};
+    // Lock-free queue, used as multi-producer single-consumer (the main thread is the only consumer).
+    static rigtorp::MPMCQueue<MainThread::TaskType> s_main_tasks {MainThread::TASK_QUEUE_CAPACITY};
+    // Tasks queued by the main thread itself while the queue is full. Only accessed by the main thread.
+    static std::deque<MainThread::TaskType> s_main_overflow_tasks {};
 
-    void MainThread::RunOnMain(const FunctionType& function)
-    {
-        std::lock_guard<std::mutex> lock (m_task_mutex);
-        m_main_tasks.push_back(function);
-    }
+    // Static initialization runs on the main thread.
+    std::thread::id MainThread::m_main_thread_id = std::this_thread::get_id();
 
-    void MainThread::RunOnMain(FunctionType&& function)
+    void MainThread::PushTask(TaskType&& task)
     {
-        std::lock_guard<std::mutex> lock (m_task_mutex);
-        m_main_tasks.emplace_back(std::move(function));
+        if (s_main_tasks.try_push(std::move(task)))
+        {
+            return;
+        }
+
+        if (IsMainThread())
+        {
+            // The main thread can't wait for itself to drain the queue.
+            s_main_overflow_tasks.emplace_back(std::move(task));
+            return;
+        }
+
+        while (!s_main_tasks.try_push(std::move(task)))
+        {
+            std::this_thread::yield();
+        }
     }
 
-    void MainThread::RunMain()
+    void MainThread::RunMain(std::chrono::microseconds time_budget)
     {
-        std::lock_guard<std::mutex> lock (m_task_mutex);
-        for (FunctionType& function : m_main_tasks)
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start_time = Clock::now();
+        const bool has_time_budget = time_budget > NO_TIME_BUDGET;
+
+        // Only the tasks that are already queued are executed.
+        size_t remaining_queued = static_cast<size_t>(std::max<ptrdiff_t>(s_main_tasks.size(), 0));
+        size_t remaining_overflow = s_main_overflow_tasks.size();
+
+        TaskType task;
+        while (remaining_queued > 0 || remaining_overflow > 0)
         {
-            function();
+            if (remaining_queued > 0)
+            {
+                remaining_queued--;
+                if (!s_main_tasks.try_pop(task))
+                {
+                    remaining_queued = 0;
+                    continue;
+                }
+            }
+            else
+            {
+                remaining_overflow--;
+                task = std::move(s_main_overflow_tasks.front());
+                s_main_overflow_tasks.pop_front();
+            }
+
+            task();
+            task.Reset();
+
+            if (has_time_budget && (Clock::now() - start_time) >= time_budget)
+            {
+                break;
+            }
         }
-        m_main_tasks.clear();
+    }
+
+    bool MainThread::IsMainThread()
+    {
+        return std::this_thread::get_id() == m_main_thread_id;
     }
 }
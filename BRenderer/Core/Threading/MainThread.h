@@ -1,9 +1,10 @@
 #ifndef BRR_MAINTHREAD_H
 #define BRR_MAINTHREAD_H
 
-#include <list>
-#include <functional>
-#include <mutex>
+#include <Core/Threading/InplaceFunction.h>
+
+#include <chrono>
+#include <thread>
 
 namespace brr::thread
 {
@@ -12,20 +13,35 @@ namespace brr::thread
     {
     public:
 
-        using FunctionType = std::function<void()>;
+        // Size in bytes of the inline storage of a main thread task. Bigger callables fail to compile.
+        static constexpr size_t TASK_STORAGE_SIZE = 56;
+        // Maximum number of tasks in the lock-free queue. Non-main threads wait for the main thread to drain a full queue.
+        static constexpr size_t TASK_QUEUE_CAPACITY = 4096;
+
+        using TaskType = InplaceFunction<TASK_STORAGE_SIZE>;
 
-        static void RunOnMain(const FunctionType& function);
+        static constexpr std::chrono::microseconds NO_TIME_BUDGET {0};
 
-        static void RunOnMain(FunctionType&& function);
+        // Queue a function to be executed on the main thread. Can be called from any thread and never allocates memory.
+        template <typename Func>
+        static void RunOnMain(Func&& function)
+        {
+            PushTask(TaskType(std::forward<Func>(function)));
+        }
 
-        static void RunMain();
+        // Run the functions queued with 'RunOnMain'. Functions queued while running are only executed on the next call.
+        // If a time budget is given, stops once it is exceeded and leaves the remaining functions for the next call.
+        static void RunMain(std::chrono::microseconds time_budget = NO_TIME_BUDGET);
+
+        static bool IsMainThread();
 
     private:
 
-        static std::list<FunctionType> m_main_tasks;
-        static std::mutex m_task_mutex;
+        static void PushTask(TaskType&& task);
+
+        static std::thread::id m_main_thread_id;
     };
 
 }
 
-#endif
\ No newline at end of file
+#endif
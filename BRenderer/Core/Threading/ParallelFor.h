@@ -0,0 +1,149 @@
+#ifndef BRR_ParallelFor_h
+#define BRR_ParallelFor_h
+#include <Core/Threading/ThreadPool.h>
+#include <Core/Threading/Work.h>
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <memory>
+
+namespace brr::thread
+{
+	/**
+	 * \brief Kernel called with a [begin, end) range of loop indices.
+	 */
+	template <typename Kernel>
+	concept RangeKernel = std::invocable<Kernel&, size_t, size_t>;
+
+	/**
+	 * \brief Chunk size value that enables adaptive chunk sizing on ParallelForWork.
+	 */
+	static constexpr size_t AUTO_CHUNK_SIZE = 0;
+
+	/**
+	 * \brief Multi-threaded loop over [begin, end), where each thread claims chunks of indices with a single atomic operation.
+	 *
+	 * The kernel is a template parameter and receives whole [begin, end) ranges, so it can be inlined and vectorized by the compiler.
+	 *
+	 * If the chunk size is AUTO_CHUNK_SIZE, chunks are sized adaptively (guided scheduling): each claim takes a fraction of the
+	 * remaining iterations, so the first chunks are large and the last ones get smaller to balance the load between threads.
+	 * \tparam Kernel Callable with signature `void(size_t begin, size_t end)`.
+	 */
+	template <RangeKernel Kernel>
+	class ParallelForWork final : public Work
+	{
+	public:
+		ParallelForWork(size_t begin, size_t end, size_t chunk_size, Kernel kernel, size_t num_threads = ThreadPool::GetDefaultPool().WorkersCount() + 1)
+		: Work(std::max(begin, end) - begin > std::max<size_t>(chunk_size, MIN_ADAPTIVE_CHUNK_SIZE)),
+		m_kernel(std::move(kernel)),
+		m_endIndex(std::max(begin, end)),
+		m_chunkSize(chunk_size),
+		m_adaptiveDivisor(std::max<size_t>(num_threads, 1) * 2),
+		m_nextIndex(begin), m_remainingIterations(m_endIndex - begin)
+		{
+			if (m_remainingIterations.load(std::memory_order_relaxed) == 0)
+			{
+				SetFinished();
+			}
+		}
+
+		void Execute() override
+		{
+			size_t chunk_begin, chunk_end;
+			while (ClaimChunk(chunk_begin, chunk_end))
+			{
+				m_kernel(chunk_begin, chunk_end);
+
+				// The thread that completes the last iterations finishes the Work. It may not be the thread that claimed the last chunk.
+				const size_t chunk_count = chunk_end - chunk_begin;
+				if (m_remainingIterations.fetch_sub(chunk_count, std::memory_order_acq_rel) == chunk_count)
+				{
+					SetFinished();
+				}
+				else if (ShouldYield())
+				{
+					// Higher priority work is pending. The ThreadPool queues this Work again to claim the remaining chunks later.
+					break;
+				}
+			}
+		}
+
+		bool WillFinishOnNextExecute() override
+		{
+			const size_t next_index = m_nextIndex.load(std::memory_order_relaxed);
+			if (next_index >= m_endIndex)
+			{
+				return true;
+			}
+			return next_index + NextChunkSize(m_endIndex - next_index) >= m_endIndex;
+		}
+
+	private:
+		static constexpr size_t MIN_ADAPTIVE_CHUNK_SIZE = 64;
+
+		size_t NextChunkSize(size_t remaining) const
+		{
+			if (m_chunkSize != AUTO_CHUNK_SIZE)
+			{
+				return m_chunkSize;
+			}
+			return std::max(remaining / m_adaptiveDivisor, MIN_ADAPTIVE_CHUNK_SIZE);
+		}
+
+		bool ClaimChunk(size_t& chunk_begin, size_t& chunk_end)
+		{
+			if (m_chunkSize != AUTO_CHUNK_SIZE)
+			{
+				chunk_begin = m_nextIndex.fetch_add(m_chunkSize, std::memory_order_relaxed);
+				if (chunk_begin >= m_endIndex)
+				{
+					return false;
+				}
+				chunk_end = std::min(chunk_begin + m_chunkSize, m_endIndex);
+				return true;
+			}
+
+			// Adaptive chunk size depends on the current index, so it requires a CAS loop.
+			chunk_begin = m_nextIndex.load(std::memory_order_relaxed);
+			do
+			{
+				if (chunk_begin >= m_endIndex)
+				{
+					return false;
+				}
+				chunk_end = std::min(chunk_begin + NextChunkSize(m_endIndex - chunk_begin), m_endIndex);
+			}
+			while (!m_nextIndex.compare_exchange_weak(chunk_begin, chunk_end, std::memory_order_relaxed));
+			return true;
+		}
+
+		Kernel m_kernel;
+		const size_t m_endIndex;
+		const size_t m_chunkSize;
+		const size_t m_adaptiveDivisor;
+
+		alignas(64) std::atomic<size_t> m_nextIndex;
+		alignas(64) std::atomic<size_t> m_remainingIterations;
+	};
+
+	/**
+	 * \brief Execute 'kernel' over [begin, end) using the calling thread and the ThreadPool. Returns only when every iteration is finished.
+	 * \param kernel Callable with signature `void(size_t begin, size_t end)`.
+	 * \param chunk_size Number of iterations claimed at once. AUTO_CHUNK_SIZE enables adaptive chunk sizing.
+	 * \param priority ThreadPool lane where the chunks are queued for the workers.
+	 */
+	template <RangeKernel Kernel>
+	void ParallelFor(size_t begin, size_t end, Kernel&& kernel, size_t chunk_size = AUTO_CHUNK_SIZE,
+	                 WorkPriority priority = WorkPriority::Normal, ThreadPool& thread_pool = ThreadPool::GetDefaultPool())
+	{
+		using KernelType = std::decay_t<Kernel>;
+		auto work = std::make_shared<ParallelForWork<KernelType>>(begin, end, chunk_size, std::forward<Kernel>(kernel), thread_pool.WorkersCount() + 1);
+		if (!work->Finished())
+		{
+			thread_pool.DoWorkParallel(std::move(work), priority);
+		}
+	}
+}
+
+#endif
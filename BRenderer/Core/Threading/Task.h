@@ -0,0 +1,455 @@
+#ifndef BRR_Task_h
+#define BRR_Task_h
+#include <Core/Threading/MainThread.h>
+#include <Core/Threading/ThreadPool.h>
+#include <Core/Threading/Work.h>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace brr::thread
+{
+	template <typename T = void>
+	class Task;
+
+	namespace detail
+	{
+		enum class TaskState : uint8_t
+		{
+			Running,
+			Detached,
+			Finished
+		};
+
+		class TaskPromiseBase
+		{
+		public:
+			struct FinalAwaiter
+			{
+				bool await_ready() const noexcept { return false; }
+
+				template <typename Promise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+				{
+					TaskPromiseBase& promise = handle.promise();
+					if (promise.m_continuation)
+					{
+						// Task was awaited. The awaiting coroutine owns the Task and destroys it after getting the result.
+						promise.m_state.store(TaskState::Finished, std::memory_order_release);
+						return promise.m_continuation;
+					}
+
+					if (promise.m_state.exchange(TaskState::Finished, std::memory_order_acq_rel) == TaskState::Detached)
+					{
+						handle.destroy();
+						return std::noop_coroutine();
+					}
+
+					promise.m_state.notify_all();
+					// Last access to the coroutine frame. After it, the Task owner is allowed to destroy it.
+					promise.m_released.store(true, std::memory_order_release);
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			FinalAwaiter final_suspend() const noexcept { return {}; }
+
+			void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+		protected:
+			template <typename>
+			friend class thread::Task;
+
+			void RethrowIfFailed() const
+			{
+				if (m_exception)
+				{
+					std::rethrow_exception(m_exception);
+				}
+			}
+
+			std::coroutine_handle<> m_continuation {};
+			std::exception_ptr m_exception {};
+			std::atomic<TaskState> m_state {TaskState::Running};
+			std::atomic_bool m_released {false};
+		};
+
+		template <typename T>
+		class TaskPromise final : public TaskPromiseBase
+		{
+		public:
+			Task<T> get_return_object() noexcept;
+
+			template <typename U = T> requires std::convertible_to<U&&, T>
+			void return_value(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>)
+			{
+				m_result.emplace(std::forward<U>(value));
+			}
+
+			T& Result()
+			{
+				RethrowIfFailed();
+				return *m_result;
+			}
+
+		private:
+			std::optional<T> m_result {};
+		};
+
+		template <>
+		class TaskPromise<void> final : public TaskPromiseBase
+		{
+		public:
+			Task<void> get_return_object() noexcept;
+
+			void return_void() const noexcept {}
+
+			void Result() const
+			{
+				RethrowIfFailed();
+			}
+		};
+	}
+
+	/**
+	 * \brief Lazy coroutine task. The coroutine only starts when the Task is awaited, started or detached.
+	 *
+	 * A Task can be awaited from another coroutine (`co_await task`), in which case the awaiting coroutine is resumed
+	 * on the thread that finishes the Task. A Task can also be started from regular code with 'Start' and waited on
+	 * with 'Wait', or be detached with 'Detach', in which case its coroutine frame destroys itself when finished.
+	 *
+	 * Executors are chosen by awaiting 'ResumeOnThreadPool', 'ResumeOnMainThread', 'NextFrame' or 'RunAsync'.
+	 * \tparam T Type of the value returned with `co_return`.
+	 */
+	template <typename T>
+	class [[nodiscard]] Task
+	{
+	public:
+		using promise_type = detail::TaskPromise<T>;
+		using HandleType = std::coroutine_handle<promise_type>;
+
+		Task() = default;
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		Task(Task&& other) noexcept
+		: m_handle(std::exchange(other.m_handle, nullptr)), m_started(std::exchange(other.m_started, false))
+		{}
+
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				DestroyHandle();
+				m_handle = std::exchange(other.m_handle, nullptr);
+				m_started = std::exchange(other.m_started, false);
+			}
+			return *this;
+		}
+
+		/**
+		 * \brief Waits for a started Task to finish before destroying it.
+		 */
+		~Task()
+		{
+			DestroyHandle();
+		}
+
+		[[nodiscard]] bool Valid() const { return m_handle != nullptr; }
+
+		[[nodiscard]] bool Done() const
+		{
+			return m_handle && m_handle.promise().m_state.load(std::memory_order_acquire) == detail::TaskState::Finished;
+		}
+
+		/**
+		 * \brief Start executing the coroutine on the calling thread, until its first suspension point.
+		 */
+		void Start()
+		{
+			assert(m_handle && !m_started && "Task is invalid or was already started.");
+			m_started = true;
+			m_handle.resume();
+		}
+
+		/**
+		 * \brief Start the Task, if not started yet, and release its ownership. The coroutine frame is destroyed when it finishes.
+		 */
+		void Detach()
+		{
+			assert(m_handle && "Can't detach an invalid Task.");
+			HandleType handle = std::exchange(m_handle, nullptr);
+			if (!std::exchange(m_started, true))
+			{
+				handle.promise().m_state.store(detail::TaskState::Detached, std::memory_order_relaxed);
+				handle.resume();
+				return;
+			}
+
+			if (handle.promise().m_state.exchange(detail::TaskState::Detached, std::memory_order_acq_rel) == detail::TaskState::Finished)
+			{
+				WaitRelease(handle);
+				handle.destroy();
+			}
+		}
+
+		/**
+		 * \brief Block the calling thread until the started Task is finished.
+		 * Must not be called from the main thread if the Task needs to resume on the main thread.
+		 */
+		void Wait() const
+		{
+			assert(m_handle && m_started && "Can't wait on a Task that was not started.");
+			promise_type& promise = m_handle.promise();
+			detail::TaskState state = promise.m_state.load(std::memory_order_acquire);
+			while (state != detail::TaskState::Finished)
+			{
+				promise.m_state.wait(state, std::memory_order_acquire);
+				state = promise.m_state.load(std::memory_order_acquire);
+			}
+			WaitRelease(m_handle);
+		}
+
+		/**
+		 * \brief Get the Task result. Rethrows any exception thrown by the coroutine. The Task must be finished.
+		 */
+		decltype(auto) Get()
+		{
+			assert(Done() && "Task result is only available after it is finished.");
+			return m_handle.promise().Result();
+		}
+
+		auto operator co_await() && noexcept
+		{
+			struct TaskAwaiter
+			{
+				HandleType handle;
+
+				bool await_ready() const noexcept { return false; }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+					handle.promise().m_continuation = awaiting;
+					return handle;
+				}
+
+				decltype(auto) await_resume()
+				{
+					if constexpr (std::is_void_v<T>)
+					{
+						handle.promise().Result();
+					}
+					else
+					{
+						return std::move(handle.promise().Result());
+					}
+				}
+			};
+
+			assert(m_handle && !m_started && "Only Tasks that were not started can be awaited.");
+			m_started = true;
+			return TaskAwaiter{m_handle};
+		}
+
+	private:
+		friend class detail::TaskPromise<T>;
+
+		explicit Task(HandleType handle) : m_handle(handle) {}
+
+		static void WaitRelease(HandleType handle)
+		{
+			promise_type& promise = handle.promise();
+			if (promise.m_continuation)
+			{
+				return;
+			}
+			while (!promise.m_released.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		void DestroyHandle()
+		{
+			if (!m_handle)
+			{
+				return;
+			}
+			if (m_started)
+			{
+				Wait();
+			}
+			m_handle.destroy();
+			m_handle = nullptr;
+		}
+
+		HandleType m_handle {};
+		bool m_started = false;
+	};
+
+	namespace detail
+	{
+		template <typename T>
+		Task<T> TaskPromise<T>::get_return_object() noexcept
+		{
+			return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+		}
+
+		inline Task<void> TaskPromise<void>::get_return_object() noexcept
+		{
+			return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+		}
+	}
+
+	/*************
+	 * Awaitables *
+	 *************/
+
+	/**
+	 * \brief Resume the awaiting coroutine on a thread of 'thread_pool', in the 'priority' lane.
+	 */
+	inline auto ResumeOnThreadPool(WorkPriority priority = WorkPriority::Normal, ThreadPool& thread_pool = ThreadPool::GetDefaultPool())
+	{
+		struct ThreadPoolAwaiter
+		{
+			ThreadPool& thread_pool;
+			WorkPriority priority;
+
+			bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<> handle) const
+			{
+				thread_pool.QueueWork(std::make_shared<FunctionWork<>>([handle] { handle.resume(); }), priority);
+			}
+
+			void await_resume() const noexcept {}
+		};
+		return ThreadPoolAwaiter{thread_pool, priority};
+	}
+
+	/**
+	 * \brief Resume the awaiting coroutine on the main thread, on the next call to 'MainThread::RunMain'.
+	 * Doesn't suspend if the coroutine is already running on the main thread.
+	 */
+	inline auto ResumeOnMainThread()
+	{
+		struct MainThreadAwaiter
+		{
+			bool await_ready() const noexcept { return MainThread::IsMainThread(); }
+
+			void await_suspend(std::coroutine_handle<> handle) const
+			{
+				MainThread::RunOnMain([handle] { handle.resume(); });
+			}
+
+			void await_resume() const noexcept {}
+		};
+		return MainThreadAwaiter{};
+	}
+
+	/**
+	 * \brief Resume the awaiting coroutine on the main thread, at the start of the next main loop frame.
+	 * By then, the render commands recorded in the current frame were already sent to the render thread.
+	 */
+	inline auto NextFrame()
+	{
+		struct NextFrameAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<> handle) const
+			{
+				MainThread::RunOnMain([handle] { handle.resume(); });
+			}
+
+			void await_resume() const noexcept {}
+		};
+		return NextFrameAwaiter{};
+	}
+
+	/**
+	 * \brief Execute 'function' on a thread of 'thread_pool' and resume the awaiting coroutine with its result.
+	 *
+	 * If awaited on the main thread, the coroutine is resumed on the main thread, so code that mutates the scene keeps
+	 * running on the main thread. Otherwise, it is resumed on the pool thread that executed the function.
+	 * Exceptions thrown by 'function' are rethrown in the awaiting coroutine.
+	 * Functions that block (e.g., reading files) should use WorkPriority::BlockingIO, so they don't occupy the compute workers.
+	 */
+	template <typename Func> requires std::invocable<Func&>
+	auto RunAsync(Func&& function, WorkPriority priority = WorkPriority::Normal, ThreadPool& thread_pool = ThreadPool::GetDefaultPool())
+	{
+		using ResultType = std::invoke_result_t<Func&>;
+		using StorageType = std::conditional_t<std::is_void_v<ResultType>, std::monostate, ResultType>;
+
+		struct RunAsyncAwaiter
+		{
+			std::decay_t<Func> function;
+			ThreadPool& thread_pool;
+			WorkPriority priority;
+			std::variant<std::monostate, StorageType, std::exception_ptr> result {};
+
+			bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				const bool resume_on_main = MainThread::IsMainThread();
+				// The awaiter lives in the suspended coroutine frame, so it is safe to reference it until the coroutine is resumed.
+				thread_pool.QueueWork(std::make_shared<FunctionWork<>>([this, handle, resume_on_main]
+				{
+					try
+					{
+						if constexpr (std::is_void_v<ResultType>)
+						{
+							function();
+							result.template emplace<1>();
+						}
+						else
+						{
+							result.template emplace<1>(function());
+						}
+					}
+					catch (...)
+					{
+						result.template emplace<2>(std::current_exception());
+					}
+
+					if (resume_on_main)
+					{
+						MainThread::RunOnMain([handle] { handle.resume(); });
+					}
+					else
+					{
+						handle.resume();
+					}
+				}), priority);
+			}
+
+			ResultType await_resume()
+			{
+				if (result.index() == 2)
+				{
+					std::rethrow_exception(std::get<2>(result));
+				}
+				if constexpr (!std::is_void_v<ResultType>)
+				{
+					return std::move(std::get<1>(result));
+				}
+			}
+		};
+		return RunAsyncAwaiter{std::forward<Func>(function), thread_pool, priority};
+	}
+}
+
+#endif
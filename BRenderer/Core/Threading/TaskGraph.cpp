@@ -0,0 +1,171 @@
+#include "TaskGraph.h"
+
+#include <Core/Threading/ThreadPool.h>
+#include <Core/LogSystem.h>
+
+#include <cassert>
+
+namespace brr::thread
+{
+	TaskGraph::~TaskGraph()
+	{
+		if (Submitted())
+		{
+			Wait();
+		}
+	}
+
+	TaskGraph::TaskID TaskGraph::AddTask(std::shared_ptr<Work> work)
+	{
+		assert(!Submitted() && "Can't add tasks to a TaskGraph that was already submitted.");
+		assert(work && "Task Work can't be null.");
+
+		const TaskID task_id = m_tasks.size();
+		std::unique_ptr<TaskNode>& node = m_tasks.emplace_back(std::make_unique<TaskNode>());
+		node->work = std::move(work);
+		return task_id;
+	}
+
+	TaskGraph::TaskID TaskGraph::AddTask(std::function<void()> function)
+	{
+		return AddTask(std::make_shared<FunctionWork<>>(std::move(function)));
+	}
+
+	void TaskGraph::AddDependency(TaskID task, TaskID predecessor)
+	{
+		assert(!Submitted() && "Can't add dependencies to a TaskGraph that was already submitted.");
+		assert(task < m_tasks.size() && predecessor < m_tasks.size() && "Invalid TaskID.");
+		assert(task != predecessor && "A task can't depend on itself.");
+
+		m_tasks[predecessor]->successors.push_back(task);
+		m_tasks[task]->predecessors_count++;
+	}
+
+	TaskGraph::TaskID TaskGraph::AddContinuation(TaskID task, std::function<void()> continuation)
+	{
+		const TaskID continuation_id = AddTask(std::move(continuation));
+		AddDependency(continuation_id, task);
+		return continuation_id;
+	}
+
+	void TaskGraph::Submit(ThreadPool& thread_pool, WorkPriority priority)
+	{
+		if (Submitted())
+		{
+			BRR_LogError("TaskGraph was already submitted.");
+			return;
+		}
+
+		if (HasCycle())
+		{
+			BRR_LogError("TaskGraph has a dependency cycle. Graph will not be submitted.");
+			return;
+		}
+
+		m_threadPool = &thread_pool;
+		m_priority = priority;
+		m_executionState->pending_tasks.store(m_tasks.size(), std::memory_order_relaxed);
+
+		if (m_tasks.empty())
+		{
+			m_executionState->finished.store(true, std::memory_order_release);
+			return;
+		}
+
+		for (TaskID task_id = 0; task_id < m_tasks.size(); ++task_id)
+		{
+			TaskNode& node = *m_tasks[task_id];
+			node.pending_predecessors.store(node.predecessors_count, std::memory_order_relaxed);
+			// The callback owns the execution state, so it outlives the graph while the last task is finishing.
+			node.work->m_completionCallback = [this, task_id, execution_state = m_executionState]
+			{
+				OnTaskFinished(task_id, *execution_state);
+			};
+		}
+
+		// Roots are collected before queueing anything, since a queued root may already be finishing its successors.
+		std::vector<TaskID> root_tasks;
+		for (TaskID task_id = 0; task_id < m_tasks.size(); ++task_id)
+		{
+			if (m_tasks[task_id]->predecessors_count == 0)
+			{
+				root_tasks.push_back(task_id);
+			}
+		}
+
+		for (TaskID task_id : root_tasks)
+		{
+			QueueTask(task_id);
+		}
+	}
+
+	void TaskGraph::QueueTask(TaskID task_id)
+	{
+		const std::shared_ptr<Work>& work = m_tasks[task_id]->work;
+		// Works with nothing to do (e.g. empty loops) finish when constructed, so their callback would never run.
+		if (work->Finished())
+		{
+			OnTaskFinished(task_id, *m_executionState);
+			return;
+		}
+		m_threadPool->QueueWork(work, m_priority);
+	}
+
+	void TaskGraph::Wait() const
+	{
+		m_executionState->finished.wait(false, std::memory_order_acquire);
+	}
+
+	void TaskGraph::OnTaskFinished(TaskID task_id, ExecutionState& execution_state)
+	{
+		for (TaskID successor_id : m_tasks[task_id]->successors)
+		{
+			TaskNode& successor = *m_tasks[successor_id];
+			if (successor.pending_predecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				QueueTask(successor_id);
+			}
+		}
+
+		// After the last task is counted, the graph may be destroyed by a thread returning from 'Wait'.
+		// Only the execution state, owned by the callback, can be accessed from here on.
+		if (execution_state.pending_tasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			execution_state.finished.store(true, std::memory_order_release);
+			execution_state.finished.notify_all();
+		}
+	}
+
+	bool TaskGraph::HasCycle() const
+	{
+		// Kahn's algorithm: the graph is acyclic if every task can be visited in topological order.
+		std::vector<uint32_t> in_degrees (m_tasks.size());
+		std::vector<TaskID> ready_tasks;
+		for (TaskID task_id = 0; task_id < m_tasks.size(); ++task_id)
+		{
+			in_degrees[task_id] = m_tasks[task_id]->predecessors_count;
+			if (in_degrees[task_id] == 0)
+			{
+				ready_tasks.push_back(task_id);
+			}
+		}
+
+		size_t visited_count = 0;
+		while (!ready_tasks.empty())
+		{
+			const TaskID task_id = ready_tasks.back();
+			ready_tasks.pop_back();
+			visited_count++;
+
+			for (TaskID successor_id : m_tasks[task_id]->successors)
+			{
+				if (--in_degrees[successor_id] == 0)
+				{
+					ready_tasks.push_back(successor_id);
+				}
+			}
+		}
+
+		return visited_count != m_tasks.size();
+	}
+}
@@ -0,0 +1,114 @@
+#ifndef BRR_TaskGraph_h
+#define BRR_TaskGraph_h
+#include <Core/Threading/Work.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace brr::thread
+{
+	class ThreadPool;
+
+	/**
+	 * \brief Directed acyclic graph of Works, submitted to a ThreadPool at once.
+	 *
+	 * Each task keeps a counter of unfinished predecessors. When a task finishes, the thread that finished it
+	 * decrements the counters of its successors and queues the ones that reach zero, so no thread blocks between
+	 * dependent tasks. Only the caller of 'Wait' blocks, and only for the whole graph.
+	 *
+	 * A TaskGraph can only be submitted once, since Works can not be executed again after finishing.
+	 * The TaskGraph must outlive its execution. Its destructor waits for a submitted graph to finish.
+	 */
+	class TaskGraph
+	{
+	public:
+		using TaskID = size_t;
+
+		TaskGraph() = default;
+
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+		~TaskGraph();
+
+		/**
+		 * \brief Add a Work as a task of the graph. The Work must not be queued anywhere else.
+		 * \return ID of the new task.
+		 */
+		TaskID AddTask(std::shared_ptr<Work> work);
+
+		/**
+		 * \brief Add a function as a task of the graph.
+		 * \return ID of the new task.
+		 */
+		TaskID AddTask(std::function<void()> function);
+
+		/**
+		 * \brief Make 'task' only start after 'predecessor' is finished.
+		 */
+		void AddDependency(TaskID task, TaskID predecessor);
+
+		/**
+		 * \brief Add a function that runs after 'task' is finished.
+		 * \return ID of the continuation task, so other tasks can depend on it.
+		 */
+		TaskID AddContinuation(TaskID task, std::function<void()> continuation);
+
+		/**
+		 * \brief Queue every task without predecessors in the pool. The remaining tasks are queued as their dependencies finish.
+		 * \param priority ThreadPool lane where every task of the graph is queued.
+		 */
+		void Submit(ThreadPool& thread_pool, WorkPriority priority = WorkPriority::Normal);
+
+		/**
+		 * \brief Block the calling thread until every task of the graph is finished.
+		 */
+		void Wait() const;
+
+		[[nodiscard]] bool Finished() const { return m_executionState->finished.load(std::memory_order_acquire); }
+
+		[[nodiscard]] bool Submitted() const { return m_threadPool != nullptr; }
+
+		[[nodiscard]] size_t TaskCount() const { return m_tasks.size(); }
+
+	private:
+		struct TaskNode
+		{
+			std::shared_ptr<Work> work;
+			std::vector<TaskID> successors {};
+			uint32_t predecessors_count = 0;
+			std::atomic<uint32_t> pending_predecessors {0};
+		};
+
+		/**
+		 * \brief Completion state of a submitted graph. Shared by the graph and the completion callbacks of its tasks,
+		 * since the thread that finishes the last task still notifies the waiting threads after 'Wait' may have returned
+		 * and the graph may have been destroyed.
+		 */
+		struct ExecutionState
+		{
+			std::atomic<size_t> pending_tasks {0};
+			std::atomic_bool finished {false};
+		};
+
+		/**
+		 * \brief Queue a task whose predecessors are finished. Tasks whose Work is already finished are completed
+		 * on the calling thread instead.
+		 */
+		void QueueTask(TaskID task_id);
+
+		void OnTaskFinished(TaskID task_id, ExecutionState& execution_state);
+
+		bool HasCycle() const;
+
+		std::vector<std::unique_ptr<TaskNode>> m_tasks {};
+		ThreadPool* m_threadPool = nullptr;
+		WorkPriority m_priority = WorkPriority::Normal;
+
+		std::shared_ptr<ExecutionState> m_executionState = std::make_shared<ExecutionState>();
+	};
+}
+
+#endif
@@ -0,0 +1,208 @@
+#include "ThreadConfig.h"
+
+#include <Core/LogSystem.h>
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace brr::thread
+{
+	namespace
+	{
+#if defined(__linux__)
+		int GetNiceLevel(ThreadPriority priority)
+		{
+			switch (priority)
+			{
+			case ThreadPriority::Lowest:  return 19;
+			case ThreadPriority::Low:     return 10;
+			case ThreadPriority::Normal:  return 0;
+			case ThreadPriority::High:    return -5;
+			case ThreadPriority::Highest: return -10;
+			}
+			return 0;
+		}
+
+		int GetRealtimePriority(ThreadPriority priority)
+		{
+			const int min_priority = sched_get_priority_min(SCHED_FIFO);
+			const int max_priority = sched_get_priority_max(SCHED_FIFO);
+			const int priority_level = static_cast<int>(priority);
+			const int max_level = static_cast<int>(ThreadPriority::Highest);
+			return min_priority + ((max_priority - min_priority) * priority_level) / max_level;
+		}
+#elif defined(_WIN32)
+		int GetWin32Priority(ThreadPriority priority, bool realtime)
+		{
+			if (realtime)
+			{
+				return THREAD_PRIORITY_TIME_CRITICAL;
+			}
+			switch (priority)
+			{
+			case ThreadPriority::Lowest:  return THREAD_PRIORITY_LOWEST;
+			case ThreadPriority::Low:     return THREAD_PRIORITY_BELOW_NORMAL;
+			case ThreadPriority::Normal:  return THREAD_PRIORITY_NORMAL;
+			case ThreadPriority::High:    return THREAD_PRIORITY_ABOVE_NORMAL;
+			case ThreadPriority::Highest: return THREAD_PRIORITY_HIGHEST;
+			}
+			return THREAD_PRIORITY_NORMAL;
+		}
+#endif
+	}
+
+	bool ApplyThreadConfig(const ThreadConfig& config)
+	{
+		bool success = true;
+#if defined(__linux__)
+		const pthread_t thread = pthread_self();
+
+		// The name of the main thread is the name of the process, so it is kept.
+		if (!config.name.empty() && gettid() != getpid())
+		{
+			// Linux thread names are limited to 16 bytes, including the null terminator.
+			const std::string thread_name = config.name.substr(0, 15);
+			if (pthread_setname_np(thread, thread_name.c_str()) != 0)
+			{
+				BRR_LogWarn("Could not set name of thread '{}'.", config.name);
+				success = false;
+			}
+		}
+
+		if (!config.cpu_affinity.empty())
+		{
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			bool has_valid_cpu = false;
+			for (uint32_t cpu : config.cpu_affinity)
+			{
+				if (cpu >= CPU_SETSIZE)
+				{
+					BRR_LogWarn("Ignoring CPU {} in affinity of thread '{}'. CPU index must be less than {}.", cpu, config.name, CPU_SETSIZE);
+					success = false;
+					continue;
+				}
+				CPU_SET(cpu, &cpu_set);
+				has_valid_cpu = true;
+			}
+			if (!has_valid_cpu)
+			{
+				BRR_LogWarn("Could not set CPU affinity of thread '{}'. No valid CPU.", config.name);
+				success = false;
+			}
+			else if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpu_set) != 0)
+			{
+				BRR_LogWarn("Could not set CPU affinity of thread '{}'.", config.name);
+				success = false;
+			}
+		}
+
+		if (config.realtime_scheduling)
+		{
+			sched_param sched_params {};
+			sched_params.sched_priority = GetRealtimePriority(config.priority);
+			if (pthread_setschedparam(thread, SCHED_FIFO, &sched_params) != 0)
+			{
+				BRR_LogWarn("Could not enable real-time scheduling of thread '{}'. Missing privileges?", config.name);
+				success = false;
+			}
+		}
+		else if (config.priority != ThreadPriority::Normal)
+		{
+			// On Linux, the nice level of a thread is set through its thread ID.
+			if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), GetNiceLevel(config.priority)) != 0)
+			{
+				BRR_LogWarn("Could not set priority of thread '{}'. Missing privileges?", config.name);
+				success = false;
+			}
+		}
+#elif defined(_WIN32)
+		const HANDLE thread = GetCurrentThread();
+
+		if (!config.name.empty())
+		{
+			const std::wstring thread_name (config.name.begin(), config.name.end());
+			if (FAILED(SetThreadDescription(thread, thread_name.c_str())))
+			{
+				BRR_LogWarn("Could not set name of thread '{}'.", config.name);
+				success = false;
+			}
+		}
+
+		if (!config.cpu_affinity.empty())
+		{
+			DWORD_PTR affinity_mask = 0;
+			for (uint32_t cpu : config.cpu_affinity)
+			{
+				if (cpu < sizeof(DWORD_PTR) * 8)
+				{
+					affinity_mask |= DWORD_PTR(1) << cpu;
+				}
+				else
+				{
+					BRR_LogWarn("Ignoring CPU {} in affinity of thread '{}'. CPU index must be less than {}.", cpu, config.name, sizeof(DWORD_PTR) * 8);
+					success = false;
+				}
+			}
+			if (affinity_mask == 0)
+			{
+				BRR_LogWarn("Could not set CPU affinity of thread '{}'. No valid CPU.", config.name);
+				success = false;
+			}
+			else if (SetThreadAffinityMask(thread, affinity_mask) == 0)
+			{
+				BRR_LogWarn("Could not set CPU affinity of thread '{}'.", config.name);
+				success = false;
+			}
+		}
+
+		if (SetThreadPriority(thread, GetWin32Priority(config.priority, config.realtime_scheduling)) == 0)
+		{
+			BRR_LogWarn("Could not set priority of thread '{}'.", config.name);
+			success = false;
+		}
+#else
+		BRR_LogWarn("Thread configuration is not supported on this platform.");
+		success = false;
+#endif
+		return success;
+	}
+
+	std::vector<uint32_t> GetAvailableCpus()
+	{
+		std::vector<uint32_t> cpus;
+#if defined(__linux__)
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		if (sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set) == 0)
+		{
+			for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+			{
+				if (CPU_ISSET(cpu, &cpu_set))
+				{
+					cpus.push_back(cpu);
+				}
+			}
+		}
+#endif
+		if (cpus.empty())
+		{
+			const uint32_t cpu_count = std::max(std::thread::hardware_concurrency(), 1u);
+			for (uint32_t cpu = 0; cpu < cpu_count; ++cpu)
+			{
+				cpus.push_back(cpu);
+			}
+		}
+		return cpus;
+	}
+}
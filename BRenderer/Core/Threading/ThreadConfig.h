@@ -0,0 +1,65 @@
+#ifndef BRR_ThreadConfig_h
+#define BRR_ThreadConfig_h
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace brr::thread
+{
+	enum class ThreadPriority
+	{
+		Lowest,
+		Low,
+		Normal,
+		High,
+		Highest
+	};
+
+	/**
+	 * \brief Configuration of an engine thread. It is applied by the thread itself when it starts.
+	 */
+	struct ThreadConfig
+	{
+		// Name shown by debuggers and profilers. Truncated to 15 characters on Linux.
+		// Not applied to the main thread on Linux, where its name is the process name shown by tools like ps and top.
+		std::string name {};
+		// CPUs the thread is allowed to run on. Empty means any CPU available to the process.
+		// CPUs that the platform can't address are ignored.
+		std::vector<uint32_t> cpu_affinity {};
+		// On Linux, maps to a nice level. Raising the priority above Normal may require privileges.
+		ThreadPriority priority = ThreadPriority::Normal;
+		// Use real-time scheduling (SCHED_FIFO on Linux). Requires privileges.
+		bool realtime_scheduling = false;
+	};
+
+	/**
+	 * \brief Configuration of every thread created by the engine.
+	 */
+	struct EngineThreadsConfig
+	{
+		ThreadConfig main_thread   { "brr-main" };
+		// Raising the render thread priority is opt-in, since on Linux it requires privileges (CAP_SYS_NICE).
+		ThreadConfig render_thread { "brr-render" };
+		// Configuration shared by all ThreadPool workers. The name is used as prefix, followed by the worker index.
+		ThreadConfig worker_threads { "brr-worker" };
+		// Number of ThreadPool workers. Zero means one less than the number of CPUs available to the workers.
+		size_t worker_count = 0;
+		// Pin the render thread to a single CPU, and keep the main thread and workers out of it.
+		bool reserve_render_core = false;
+		// Pin each worker to a single CPU, distributing the workers between the available CPUs.
+		bool pin_workers = false;
+	};
+
+	/**
+	 * \brief Apply the configuration to the calling thread. Settings that can't be applied are logged as warnings.
+	 * \return true if every setting was applied.
+	 */
+	bool ApplyThreadConfig(const ThreadConfig& config);
+
+	/**
+	 * \brief Get the CPUs the process is allowed to run on.
+	 */
+	std::vector<uint32_t> GetAvailableCpus();
+}
+
+#endif
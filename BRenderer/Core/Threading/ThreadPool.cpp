@@ -1,32 +1,111 @@
 #include "ThreadPool.h"
 
 #include <Core/Threading/Work.h>
+#include <Core/LogSystem.h>
 
-#include <iostream>
+#include <algorithm>
+#include <string>
 
 namespace brr::thread
 {
+	// Number of failed work searches before an idle worker parks.
+	static constexpr uint32_t IDLE_SPIN_COUNT = 64;
+	// Number of random victims a worker tries to steal from on each search.
+	static constexpr uint32_t STEAL_ATTEMPTS_MULTIPLIER = 2;
+
+	static thread_local ThreadPool* t_currentPool = nullptr;
+	static thread_local size_t t_workerIndex = 0;
+	// Lane of the Work being executed by the current thread, and if it yielded to higher priority work.
+	static thread_local size_t t_currentLane = 0;
+	static thread_local bool t_workYielded = false;
+
+	static uint64_t NextRandom(uint64_t& state)
+	{
+		// xorshift64
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	static ThreadPoolConfig s_defaultPoolConfig {};
+	static std::atomic<bool> s_defaultPoolCreated = false;
+
     ThreadPool& ThreadPool::GetDefaultPool()
     {
-		static ThreadPool thread_pool {};
+		static ThreadPool thread_pool = [] ()
+		{
+			s_defaultPoolCreated = true;
+			return ThreadPool(s_defaultPoolConfig);
+		}();
 		return thread_pool;
     }
 
-	ThreadPool::ThreadPool() : ThreadPool(std::thread::hardware_concurrency() - 1)
+	bool ThreadPool::ConfigureDefaultPool(const ThreadPoolConfig& config)
+	{
+		if (s_defaultPoolCreated)
+		{
+			BRR_LogWarn("Default ThreadPool was already created. Ignoring new configuration.");
+			return false;
+		}
+		s_defaultPoolConfig = config;
+		return true;
+	}
+
+	ThreadPool::ThreadPool() : ThreadPool(ThreadPoolConfig{})
+	{
+
+	}
+
+	ThreadPool::ThreadPool(size_t num_threads) : ThreadPool(ThreadPoolConfig{ std::max<size_t>(num_threads, 1) })
 	{
 
 	}
 
-	ThreadPool::ThreadPool(size_t num_threads) : m_workQueue(), m_workerThreads(), m_runningThreads(0)
+	ThreadPool::ThreadPool(const ThreadPoolConfig& config)
+	: m_runningThreads(0), m_workEpoch(0), m_sleepingWorkers(0), m_stopWorkerThreads(false)
     {
-		std::cout << "Creating ThreadPool with " << num_threads << "threads\n";
+		const std::vector<uint32_t> worker_cpus = config.worker_config.cpu_affinity.empty() ? GetAvailableCpus()
+		                                                                                    : config.worker_config.cpu_affinity;
+		const size_t num_threads = (config.num_threads > 0) ? config.num_threads
+		                                                    : std::max<size_t>(worker_cpus.size(), 2) - 1;
+
+		BRR_LogInfo("Creating ThreadPool with {} threads", num_threads);
 		// Pre-allocate the pool
+		m_workers.reserve(num_threads);
 		m_workerThreads.reserve(num_threads);
 
-		for (int i = 0; i < num_threads; ++i)
+		for (size_t i = 0; i < num_threads; ++i)
 		{
+			std::unique_ptr<Worker>& worker = m_workers.emplace_back(std::make_unique<Worker>());
+			worker->rngState = 0x9E3779B97F4A7C15ull * (i + 1);
+		}
+
+		for (size_t i = 0; i < num_threads; ++i)
+		{
+			ThreadConfig thread_config = config.worker_config;
+			if (!thread_config.name.empty())
+			{
+				thread_config.name += "-" + std::to_string(i);
+			}
+			if (config.pin_workers)
+			{
+				thread_config.cpu_affinity = { worker_cpus[i % worker_cpus.size()] };
+			}
+
 			// Create worker threads
-			m_workerThreads.emplace_back(&ThreadPool::WorkerThreadFunc, this, i + 1);
+			m_workerThreads.emplace_back(&ThreadPool::WorkerThreadFunc, this, i, std::move(thread_config));
+		}
+
+		m_ioThreads.reserve(config.num_io_threads);
+		for (size_t i = 0; i < config.num_io_threads; ++i)
+		{
+			ThreadConfig thread_config = config.io_thread_config;
+			if (!thread_config.name.empty())
+			{
+				thread_config.name += "-" + std::to_string(i);
+			}
+			m_ioThreads.emplace_back(&ThreadPool::IOThreadFunc, this, std::move(thread_config));
 		}
 	}
 
@@ -35,24 +114,68 @@ namespace brr::thread
 		// Indicate that worker threads should stop
 		m_stopWorkerThreads = true;
 		// Notify sleeping worker threads
-		m_workReadyCondition.notify_all();
+		m_workEpoch.fetch_add(1);
+		m_workEpoch.notify_all();
+		{
+			std::lock_guard io_lock (m_ioMutex);
+			m_ioCondition.notify_all();
+		}
 		// Join all the threads with the main thread.
 		for (std::thread& thread : m_workerThreads)
 		{
 			if (thread.joinable())
 				thread.join();
 		}
+		for (std::thread& thread : m_ioThreads)
+		{
+			if (thread.joinable())
+				thread.join();
+		}
+
+		// Release Works that were never executed.
+		for (std::unique_ptr<Worker>& worker : m_workers)
+		{
+			for (WorkStealingDeque<Work*>& deque : worker->deques)
+			{
+				while (std::optional<Work*> work = deque.Pop())
+				{
+					ReleaseQueueRef(*work);
+				}
+			}
+		}
+		for (Lane& lane : m_lanes)
+		{
+			for (Work* work : lane.injectionQueue)
+			{
+				ReleaseQueueRef(work);
+			}
+			lane.injectionQueue.clear();
+		}
+		for (Work* work : m_ioQueue)
+		{
+			ReleaseQueueRef(work);
+		}
+		m_ioQueue.clear();
 	}
 
-	void ThreadPool::QueueWork(std::shared_ptr<Work> work)
+	void ThreadPool::QueueWork(std::shared_ptr<Work> work, WorkPriority priority)
 	{
-		std::lock_guard queueLock (m_workQueueMutex);
-		m_workQueue.emplace_back(std::move(work));
-
-		m_workReadyCondition.notify_all();
+		Work* work_ptr = work.get();
+		AcquireQueueRef(std::move(work));
+		if (priority == WorkPriority::BlockingIO)
+		{
+			if (!m_ioThreads.empty())
+			{
+				PushIOWork(work_ptr);
+				return;
+			}
+			// Pool without IO threads. Blocking works run in the lowest compute lane.
+			priority = WorkPriority::Background;
+		}
+		PushWork(work_ptr, static_cast<size_t>(priority));
 	}
 
-	void ThreadPool::DoWorkParallel(std::shared_ptr<Work> work)
+	void ThreadPool::DoWorkParallel(std::shared_ptr<Work> work, WorkPriority priority)
 	{
 		if (!work->MultiThreadedWork())
 		{
@@ -60,57 +183,277 @@ namespace brr::thread
 			return;
 		}
 
+		QueueWork(work, priority);
+
+		// The calling thread is waiting for this Work, so it must not yield it.
+		const size_t previous_lane = t_currentLane;
+		t_currentLane = 0;
+
+		// TODO: If there are other works in the queue, the main thread may end up running all the work. Is this the best approach? Maybe better than waiting for other works to finish
+		work->Execute();
+
+		t_currentLane = previous_lane;
+
+		// Remaining chunks are already being executed by worker threads.
+		work->Wait();
+	}
+
+	bool ThreadPool::ShouldYieldCurrentWork()
+	{
+		if (!t_currentPool || !t_currentPool->HasHigherPriorityWork(t_currentLane))
+		{
+			return false;
+		}
+		t_workYielded = true;
+		return true;
+	}
+
+	void ThreadPool::WorkerThreadFunc(size_t thread_idx, ThreadConfig thread_config)
+	{
+		ApplyThreadConfig(thread_config);
+
+		t_currentPool = this;
+		t_workerIndex = thread_idx;
+
+		uint32_t failed_searches = 0;
+		while (!m_stopWorkerThreads.load(std::memory_order_relaxed))
 		{
-			std::lock_guard queueLock (m_workQueueMutex);
+			size_t lane_idx;
+			if (Work* work = FindWork(thread_idx, lane_idx))
+			{
+				failed_searches = 0;
+				RunWork(work, lane_idx);
+				continue;
+			}
 
-			m_workQueue.emplace_back(std::move(work));
+			if (++failed_searches < IDLE_SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
 
-			m_workReadyCondition.notify_all();
+			failed_searches = 0;
+			ParkWorker();
 		}
 
-		// TODO: If there are other works in the queue, the main thread may end up running all the work. Is this the best approach? Maybe better than waiting for other works to finish
-		while (!work->Finished())
+		t_currentPool = nullptr;
+	}
+
+	void ThreadPool::IOThreadFunc(ThreadConfig thread_config)
+	{
+		ApplyThreadConfig(thread_config);
+
+		while (true)
 		{
+			Work* work;
+			{
+				std::unique_lock io_lock (m_ioMutex);
+				m_ioCondition.wait(io_lock, [this] { return m_stopWorkerThreads || !m_ioQueue.empty(); });
+				if (m_stopWorkerThreads)
+				{
+					break;
+				}
+				work = m_ioQueue.front();
+				m_ioQueue.pop_front();
+			}
+
 			work->Execute();
+			ReleaseQueueRef(work);
+		}
+	}
+
+	void ThreadPool::PushWork(Work* work, size_t lane_idx)
+	{
+		Lane& lane = m_lanes[lane_idx];
+		// Counted before the push, so the count is never lower than the number of queued works.
+		lane.queuedCount.fetch_add(1, std::memory_order_seq_cst);
+
+		if (t_currentPool == this)
+		{
+			m_workers[t_workerIndex]->deques[lane_idx].Push(work);
+		}
+		else
+		{
+			std::lock_guard injection_lock (m_injectionMutex);
+			lane.injectionQueue.push_back(work);
+			lane.injectedCount.fetch_add(1, std::memory_order_release);
 		}
 
-		work->m_finishedCondition.notify_all();
+		m_workEpoch.fetch_add(1, std::memory_order_seq_cst);
+		if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+		{
+			m_workEpoch.notify_one();
+		}
 	}
 
-	void ThreadPool::WorkerThreadFunc(size_t thread_idx)
+	void ThreadPool::PushIOWork(Work* work)
 	{
-		while (!m_stopWorkerThreads)
 		{
-			std::unique_lock lock(m_workQueueMutex);
-			if (m_workQueue.empty())
+			std::lock_guard io_lock (m_ioMutex);
+			m_ioQueue.push_back(work);
+		}
+		m_ioCondition.notify_one();
+	}
+
+	Work* ThreadPool::FindWork(size_t thread_idx, size_t& out_lane_idx)
+	{
+		for (size_t lane_idx = 0; lane_idx < COMPUTE_LANES_COUNT; ++lane_idx)
+		{
+			Lane& lane = m_lanes[lane_idx];
+			if (lane.queuedCount.load(std::memory_order_relaxed) == 0)
+			{
+				continue;
+			}
+
+			Work* work = nullptr;
+			if (std::optional<Work*> local_work = m_workers[thread_idx]->deques[lane_idx].Pop())
 			{
-				m_workReadyCondition.wait(lock/*, [&]{ return !m_workQueue.empty();  }*/);
+				work = *local_work;
 			}
-			else
+			else if (!((work = PopInjectedWork(lane_idx))))
 			{
-				const std::shared_ptr<Work> work = m_workQueue.front();
+				work = StealWork(thread_idx, lane_idx);
+			}
 
-				bool isRemoved = false;
-				// Remove the Work from the queue if the Work will finish after the next 'Execute' call.
-				// It is not removed from the queue if the Work will require more processing after that.
-				if (work->WillFinishOnNextExecute())
-				{
-					isRemoved = true;
-					m_workQueue.pop_front();
-				}
+			if (work)
+			{
+				lane.queuedCount.fetch_sub(1, std::memory_order_relaxed);
+				out_lane_idx = lane_idx;
+				return work;
+			}
+		}
+		return nullptr;
+	}
 
-				lock.unlock();
+	Work* ThreadPool::PopInjectedWork(size_t lane_idx)
+	{
+		Lane& lane = m_lanes[lane_idx];
+		// Avoid taking the lock when the injection queue is empty.
+		if (lane.injectedCount.load(std::memory_order_acquire) == 0)
+		{
+			return nullptr;
+		}
 
-				work->Execute();
+		std::lock_guard injection_lock (m_injectionMutex);
+		if (lane.injectionQueue.empty())
+		{
+			return nullptr;
+		}
 
-				lock.lock();
+		Work* work = lane.injectionQueue.front();
+		lane.injectionQueue.pop_front();
+		lane.injectedCount.fetch_sub(1, std::memory_order_relaxed);
+		return work;
+	}
 
-				if (work->Finished())
-				{
-					work->m_finishedCondition.notify_all();
-					m_workReadyCondition.notify_all();
-				}
+	Work* ThreadPool::StealWork(size_t thread_idx, size_t lane_idx)
+	{
+		const size_t num_workers = m_workers.size();
+		if (num_workers < 2)
+		{
+			return nullptr;
+		}
+
+		Worker& worker = *m_workers[thread_idx];
+		for (size_t attempt = 0; attempt < num_workers * STEAL_ATTEMPTS_MULTIPLIER; ++attempt)
+		{
+			size_t victim_idx = NextRandom(worker.rngState) % (num_workers - 1);
+			// Skip the worker's own deque.
+			if (victim_idx >= thread_idx)
+			{
+				++victim_idx;
+			}
+
+			if (std::optional<Work*> work = m_workers[victim_idx]->deques[lane_idx].Steal())
+			{
+				return *work;
+			}
+		}
+		return nullptr;
+	}
+
+	void ThreadPool::RunWork(Work* work, size_t lane_idx)
+	{
+		m_runningThreads.fetch_add(1, std::memory_order_relaxed);
+		t_currentLane = lane_idx;
+		t_workYielded = false;
+
+		// If the Work will require more processing after this 'Execute' call,
+		// publish it again so that other workers can steal it and help with the remaining chunks.
+		if (!work->WillFinishOnNextExecute())
+		{
+			AcquireQueueRef(work);
+			PushWork(work, lane_idx);
+		}
+
+		work->Execute();
+
+		// The Work stopped at a chunk boundary to let higher priority work run. Queue it again to continue later.
+		if (t_workYielded && !work->Finished())
+		{
+			AcquireQueueRef(work);
+			PushWork(work, lane_idx);
+		}
+
+		m_runningThreads.fetch_sub(1, std::memory_order_relaxed);
+
+		ReleaseQueueRef(work);
+	}
+
+	void ThreadPool::ParkWorker()
+	{
+		const uint32_t epoch = m_workEpoch.load(std::memory_order_seq_cst);
+		m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+
+		// Check again after announcing the worker is sleeping, so a concurrent push is never missed.
+		const bool has_work = std::ranges::any_of(m_lanes, [](const Lane& lane) { return lane.queuedCount.load(std::memory_order_seq_cst) > 0; });
+
+		if (!has_work && !m_stopWorkerThreads.load(std::memory_order_seq_cst))
+		{
+			m_workEpoch.wait(epoch, std::memory_order_seq_cst);
+		}
+
+		m_sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+	}
+
+	bool ThreadPool::HasHigherPriorityWork(size_t lane_idx) const
+	{
+		for (size_t higher_lane_idx = 0; higher_lane_idx < lane_idx; ++higher_lane_idx)
+		{
+			if (m_lanes[higher_lane_idx].queuedCount.load(std::memory_order_relaxed) > 0)
+			{
+				return true;
 			}
 		}
+		return false;
+	}
+
+	void ThreadPool::AcquireQueueRef(Work* work)
+	{
+		// Caller already owns a queue reference, so the Work is kept alive.
+		work->m_queueRefs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void ThreadPool::AcquireQueueRef(std::shared_ptr<Work>&& work)
+	{
+		Work* work_ptr = work.get();
+		if (work_ptr->m_queueRefs.fetch_add(1, std::memory_order_acq_rel) == 0)
+		{
+			work_ptr->m_queueKeepAlive = std::move(work);
+		}
+	}
+
+	void ThreadPool::ReleaseQueueRef(Work* work)
+	{
+		if (work->m_queueRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			// Last queue reference. The Work may be destroyed here.
+			std::shared_ptr<Work> keep_alive = std::move(work->m_queueKeepAlive);
+		}
+	}
+
+	bool Work::ShouldYield()
+	{
+		return ThreadPool::ShouldYieldCurrentWork();
 	}
 }
@@ -1,23 +1,64 @@
 #ifndef BRR_ThreadPool_h
 #define BRR_ThreadPool_h
+#include <Core/Threading/ThreadConfig.h>
+#include <Core/Threading/Work.h>
+#include <Core/Threading/WorkStealingDeque.h>
+
+#include <array>
 #include <vector>
-#include <list>
+#include <deque>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
+#include <memory>
 
 namespace brr::thread
 {
-	class Work;
 
+	struct ThreadPoolConfig
+	{
+		// Number of worker threads. Zero means one less than the number of CPUs available to the workers.
+		size_t num_threads = 0;
+		// Configuration applied to every worker. The name is used as prefix, followed by the worker index.
+		ThreadConfig worker_config { "brr-worker" };
+		// Pin each worker to a single CPU of 'worker_config.cpu_affinity' (or of the available CPUs, if empty).
+		bool pin_workers = false;
+		// Number of threads dedicated to WorkPriority::BlockingIO works. They are not pinned, since they mostly sleep.
+		size_t num_io_threads = 2;
+		ThreadConfig io_thread_config { "brr-io" };
+	};
+
+	/**
+	 * \brief Work-stealing thread pool.
+	 *
+	 * Each worker thread owns a Chase-Lev deque. Works queued from a worker thread go to its own deque,
+	 * while works queued from any other thread go to a shared injection queue. Idle workers first drain their own
+	 * deque, then the injection queue, and finally try to steal from randomly chosen workers before parking.
+	 *
+	 * Multi-threaded Works (i.e., that can be divided in chunks) are re-published in the executing worker's deque
+	 * before being executed, so idle workers can steal them and help with the remaining chunks.
+	 *
+	 * Works are queued in priority lanes (see WorkPriority). Each lane has its own deques and injection queue, and
+	 * workers always search the higher lanes first. Works executing in a lower lane yield at chunk boundaries when a
+	 * higher lane has pending work, and are queued again to continue later.
+	 * BlockingIO works run on a separate set of threads, so they never occupy the compute workers.
+	 */
 	class ThreadPool
 	{
 	public:
 
 		static ThreadPool& GetDefaultPool();
 
+		/**
+		 * \brief Set the configuration used to create the default pool.
+		 * \return false if the default pool was already created, in which case the configuration is ignored.
+		 */
+		static bool ConfigureDefaultPool(const ThreadPoolConfig& config);
+
 		ThreadPool();
 		ThreadPool(size_t num_threads);
+		ThreadPool(const ThreadPoolConfig& config);
 
 		ThreadPool(ThreadPool&) = delete;
 		ThreadPool(ThreadPool&&) = delete;
@@ -30,33 +71,102 @@ namespace brr::thread
 		/**
 		 * \brief Queue a work in the work queue, where a thread from the thread pool will execute the work.
 		 * \param work A shared_ptr of the work to be executed.
+		 * \param priority Lane where the work is queued.
 		 */
-		void QueueWork(std::shared_ptr<Work> work);
+		void QueueWork(std::shared_ptr<Work> work, WorkPriority priority = WorkPriority::Normal);
 
 		/**
 		 * \brief Queue a work in the work queue, and also uses the main thread to help the pool with the work execution. The function only returns when the work is finished.
 		 * If the Work is not MultiThreaded (i.e., can be divided into multiple chunks of work), then the main thread will execute it and return.
 		 * \param work A shared_ptr of the work to be executed.
+		 * \param priority Lane where the work is queued for the worker threads.
 		 */
-		void DoWorkParallel(std::shared_ptr<Work> work);
+		void DoWorkParallel(std::shared_ptr<Work> work, WorkPriority priority = WorkPriority::Normal);
+
+		[[nodiscard]] size_t WorkersCount() const { return m_workerThreads.size(); }
 
-		[[nodiscard]] constexpr size_t AvailableWorkers() const { return (m_workerThreads.size() - m_runningThreads); }
+		[[nodiscard]] size_t AvailableWorkers() const { return (m_workerThreads.size() - m_runningThreads.load(std::memory_order_relaxed)); }
+
+		[[nodiscard]] size_t IOThreadsCount() const { return m_ioThreads.size(); }
+
+		/**
+		 * \brief Check if the calling worker should stop executing its current Work because a higher priority lane has pending work.
+		 * Always false on threads that are not compute workers of a pool.
+		 */
+		static bool ShouldYieldCurrentWork();
 
 	private:
+		static constexpr size_t COMPUTE_LANES_COUNT = static_cast<size_t>(WorkPriority::BlockingIO);
+
+		struct alignas(64) Worker
+		{
+			std::array<WorkStealingDeque<Work*>, COMPUTE_LANES_COUNT> deques {};
+			uint64_t rngState = 0;
+		};
+
+		struct alignas(64) Lane
+		{
+			// Number of works queued in this lane (deques + injection queue). Used to skip empty lanes and to preempt lower lanes.
+			std::atomic<size_t> queuedCount {0};
+			std::atomic<size_t> injectedCount {0};
+			std::deque<Work*> injectionQueue {};
+		};
+
+		void WorkerThreadFunc(size_t thread_idx, ThreadConfig thread_config);
 
-		void WorkerThreadFunc(size_t thread_idx);
+		void IOThreadFunc(ThreadConfig thread_config);
 
-		std::list<std::shared_ptr<Work>> m_workQueue{};
+		/**
+		 * \brief Push a Work that already holds a queue reference into the current worker deque of the lane, or into the
+		 * lane injection queue if the calling thread is not a worker of this pool. Wakes a parked worker if there is any.
+		 */
+		void PushWork(Work* work, size_t lane_idx);
+
+		void PushIOWork(Work* work);
+
+		/**
+		 * \brief Find a Work for the worker 'thread_idx'. Lanes are searched in priority order. In each lane, searches
+		 * its own deque first, then the injection queue and then steal from other workers.
+		 * \return Work with a queue reference owned by the caller. `nullptr` if no work was found.
+		 */
+		Work* FindWork(size_t thread_idx, size_t& out_lane_idx);
+
+		Work* PopInjectedWork(size_t lane_idx);
+
+		Work* StealWork(size_t thread_idx, size_t lane_idx);
+
+		void RunWork(Work* work, size_t lane_idx);
+
+		void ParkWorker();
+
+		bool HasHigherPriorityWork(size_t lane_idx) const;
+
+		static void AcquireQueueRef(Work* work);
+		static void AcquireQueueRef(std::shared_ptr<Work>&& work);
+		static void ReleaseQueueRef(Work* work);
+
+		std::vector<std::unique_ptr<Worker>> m_workers{};
 		std::vector<std::thread> m_workerThreads{};
 
-		size_t m_runningThreads;
+		std::atomic<size_t> m_runningThreads;
+
+		// Works queued by threads that are not workers of this pool are stored in the lanes injection queues.
+		std::mutex m_injectionMutex;
+		std::array<Lane, COMPUTE_LANES_COUNT> m_lanes {};
+
+		// Blocking IO works. Executed in FIFO order by the IO threads.
+		std::vector<std::thread> m_ioThreads{};
+		std::mutex m_ioMutex;
+		std::condition_variable m_ioCondition;
+		std::deque<Work*> m_ioQueue{};
 
-		std::mutex m_workQueueMutex;
-		std::condition_variable m_workReadyCondition;
+		// Idle parking. Workers wait on 'm_workEpoch', which is incremented every time new work is pushed.
+		alignas(64) std::atomic<uint32_t> m_workEpoch;
+		alignas(64) std::atomic<uint32_t> m_sleepingWorkers;
 
 		std::atomic<bool> m_stopWorkerThreads;
 	};
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -3,6 +3,12 @@
 
 #include <Core/Threading/Barrier.h>
 #include <Core/Threading/Work.h>
+#include <Core/Threading/ThreadConfig.h>
 #include <Core/Threading/ThreadPool.h>
+#include <Core/Threading/TaskGraph.h>
+#include <Core/Threading/ParallelFor.h>
+#include <Core/Threading/Task.h>
+#include <Core/Threading/WaitSignal.h>
+#include <Core/Threading/WorkStealingDeque.h>
 
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef BRR_WaitSignal_h
+#define BRR_WaitSignal_h
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace brr::thread
+{
+	/**
+	 * \brief Hint to the CPU that the calling thread is spinning.
+	 */
+	inline void CpuRelax()
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	/**
+	 * \brief Signal used to wait for a condition that is changed by another thread, like a lock-free queue becoming non-empty.
+	 *
+	 * 'WaitUntil' spins for a short time and then blocks with atomic wait (a futex on Linux) until the condition is true.
+	 * The thread that changes the condition must call 'Notify' after changing it.
+	 */
+	class WaitSignal
+	{
+	public:
+		static constexpr uint32_t DEFAULT_SPIN_COUNT = 256;
+
+		/**
+		 * \brief Wake up the threads waiting on this signal, so they check their condition again.
+		 */
+		void Notify()
+		{
+			m_sequence.fetch_add(1, std::memory_order_release);
+			m_sequence.notify_all();
+		}
+
+		/**
+		 * \brief Block the calling thread until 'condition' returns true.
+		 * \param condition Predicate checked on every wake up.
+		 * \param spin_count Number of times the condition is checked before blocking.
+		 */
+		template <typename Predicate>
+		void WaitUntil(Predicate&& condition, uint32_t spin_count = DEFAULT_SPIN_COUNT)
+		{
+			for (uint32_t spin = 0; spin < spin_count; ++spin)
+			{
+				if (condition())
+				{
+					return;
+				}
+				CpuRelax();
+			}
+
+			while (true)
+			{
+				// The sequence is read before checking the condition, so a Notify between the check and the wait is not lost.
+				const uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+				if (condition())
+				{
+					return;
+				}
+				m_sequence.wait(sequence, std::memory_order_acquire);
+			}
+		}
+
+	private:
+		std::atomic<uint32_t> m_sequence {0};
+	};
+}
+
+#endif
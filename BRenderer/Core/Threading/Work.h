@@ -1,14 +1,31 @@
 #ifndef BRR_Work_h
 #define BRR_Work_h
-#include <mutex>
+#include <atomic>
+#include <memory>
+#include <algorithm>
 #include <functional>
-#include <iostream>
+#include <tuple>
 
 namespace brr::thread
 {
+	/**
+	 * \brief ThreadPool lane where a Work is queued. Lanes are ordered from highest to lowest priority.
+	 */
+	enum class WorkPriority : uint8_t
+	{
+		// Work that the current frame is waiting on.
+		Critical,
+		Normal,
+		// Work that can take several frames to finish, like asset decoding.
+		Background,
+		// Work that blocks waiting for IO. Runs on dedicated threads, outside the compute workers.
+		BlockingIO
+	};
+
 	class Work
 	{
 		friend class ThreadPool;
+		friend class TaskGraph;
 	public:
 		Work(bool multi_threaded = false) : m_dividibleInChunks(multi_threaded), m_finished(false) { }
 
@@ -22,25 +39,47 @@ namespace brr::thread
 		 */
 		[[nodiscard]] bool MultiThreadedWork() const { return m_dividibleInChunks; }
 
-		[[nodiscard]] bool Finished() const { return m_finished; };
+		[[nodiscard]] bool Finished() const { return m_finished.load(std::memory_order_acquire); };
 
-		//TODO: Add Wait function  (Maybe 'WaitStart', 'WaitFinish', ... ?)
-		void Wait()
+		/**
+		 * \brief Block the calling thread until the Work is finished.
+		 */
+		void Wait() const
 		{
-			std::unique_lock<std::mutex> lock(m_workMutex);
-
-			if (m_finished)
-				return;
-
-			m_finishedCondition.wait(lock, [&] { return m_finished.load(); });
+			m_finished.wait(false, std::memory_order_acquire);
 		}
 
 	protected:
-		std::mutex m_workMutex;
-		std::condition_variable m_finishedCondition;
+		/**
+		 * \brief Check if the Work should stop at the current chunk boundary, so a higher priority Work can run.
+		 * The ThreadPool queues the Work again after it yields.
+		 */
+		static bool ShouldYield();
+
+		/**
+		 * \brief Mark the Work as finished and wake up every thread waiting on it.
+		 */
+		void SetFinished()
+		{
+			if (m_completionCallback)
+			{
+				m_completionCallback();
+			}
+			m_finished.store(true, std::memory_order_release);
+			m_finished.notify_all();
+		}
 
 		const bool m_dividibleInChunks;
 		std::atomic_bool m_finished;
+
+	private:
+		// Number of references to this Work held by the ThreadPool queues.
+		// While it is greater than zero, 'm_queueKeepAlive' keeps the Work alive.
+		std::atomic<uint32_t> m_queueRefs {0};
+		std::shared_ptr<Work> m_queueKeepAlive {};
+
+		// Called by the thread that finishes the Work, right before it is marked as finished. Set by the TaskGraph.
+		std::function<void()> m_completionCallback {};
 	};
 
 	template<typename... Args>
@@ -56,7 +95,7 @@ namespace brr::thread
 		{
 			std::apply(function, args);
 
-			m_finished = true;
+			SetFinished();
 		}
 
 		bool WillFinishOnNextExecute() override
@@ -82,61 +121,57 @@ namespace brr::thread
 		: ForLoopWork(0, end_iter, chunk_size, std::forward<LoopFunc>(loop_func)) {}
 
 		ForLoopWork(iterator start_iter, iterator end_iter, size_t chunk_size, LoopFunc&& loop_func)
-		: Work((end_iter - start_iter) > chunk_size),
-		m_currentIter(start_iter), m_endIter(end_iter), m_loopFunc(std::move(loop_func)),
-		m_chunkSize(std::min(chunk_size, static_cast<size_t>(end_iter - start_iter))), m_numThreads(0)
-		{}
-		
-		~ForLoopWork() override { std::cout << "destructing for loop work\n"; }
+		: Work(static_cast<size_t>(end_iter - start_iter) > chunk_size),
+		m_startIter(start_iter),
+		m_iterationsCount(static_cast<size_t>(end_iter - start_iter)),
+		m_chunkSize(std::max<size_t>(std::min(chunk_size, m_iterationsCount), 1)),
+		m_loopFunc(std::move(loop_func)),
+		m_nextIteration(0), m_remainingIterations(m_iterationsCount)
+		{
+			if (m_iterationsCount == 0)
+				SetFinished();
+		}
+
+		~ForLoopWork() override = default;
 
 		void Execute() override
 		{
-			std::unique_lock<std::mutex> lock (loopMutex);
-			while (m_currentIter != m_endIter)
+			while (true)
 			{
-				iterator startIt = m_currentIter;
-				iterator endIt = std::min(m_currentIter + m_chunkSize, m_endIter);
-				m_currentIter = endIt;
-
-				m_numThreads++;
-
-				lock.unlock();
+				// Claim the next chunk of iterations.
+				const size_t chunk_begin = m_nextIteration.fetch_add(m_chunkSize, std::memory_order_relaxed);
+				if (chunk_begin >= m_iterationsCount)
+					break;
+				const size_t chunk_end = std::min(chunk_begin + m_chunkSize, m_iterationsCount);
 
-				for (iterator it = startIt; it < endIt; ++it)
+				for (size_t it = chunk_begin; it < chunk_end; ++it)
 				{
-					m_loopFunc(it);
+					m_loopFunc(m_startIter + it);
 				}
 
-				lock.lock();
-
-				m_numThreads--;
-
-				// The work is only finished once the number of iterations ends,
-				// and there is no more threads working on any of other iterations.
+				// The work is only finished once every iteration is computed.
 				// (Note that the thread that picked the last iterations might finish before a
-				// thread that picked previous loop iterations, thus requiring the check for the number of threads working before finishing.)
-				if (m_currentIter == m_endIter && m_numThreads == 0)
-					m_finished = true;
+				// thread that picked previous loop iterations, thus the counter of remaining iterations.)
+				const size_t chunk_count = chunk_end - chunk_begin;
+				if (m_remainingIterations.fetch_sub(chunk_count, std::memory_order_acq_rel) == chunk_count)
+					SetFinished();
+				else if (ShouldYield())
+					break;
 			}
 		}
 
 		bool WillFinishOnNextExecute() override
 		{
-			iterator currIt;
-			{
-				std::scoped_lock<std::mutex> lock (loopMutex);
-				currIt = m_currentIter;
-			}
-			return std::min(currIt + m_chunkSize, m_endIter) == m_endIter;
+			return m_nextIteration.load(std::memory_order_relaxed) + m_chunkSize >= m_iterationsCount;
 		}
 
 	private:
-		iterator m_currentIter;
-		const iterator m_endIter;
+		const iterator m_startIter;
+		const size_t m_iterationsCount;
 		const size_t m_chunkSize;
-		size_t m_numThreads;
-		std::mutex loopMutex;
 		LoopFunc m_loopFunc;
+		std::atomic<size_t> m_nextIteration;
+		std::atomic<size_t> m_remainingIterations;
 	};
 
 	class ForLoop2DWork final : public Work
@@ -151,80 +186,68 @@ namespace brr::thread
 		ForLoop2DWork(std::pair<size_t, size_t> start_iter_pair, 
 			std::pair<size_t, size_t> end_iter_pair, 
 			std::pair<size_t,size_t> chunk_size, Loop2DFunc&& loop_func) :
-			Work(true/*chunk_size.first < static_cast<size_t>(end_iter_pair.first - start_iter_pair.first) 
-				|| chunk_size.second < static_cast<size_t>(end_iter_pair.second - start_iter_pair.second)*/),
-			m_currentIter(start_iter_pair), m_endIter(end_iter_pair),
-			m_chunkSize(std::min(chunk_size.first, static_cast<size_t>(end_iter_pair.first - start_iter_pair.first)), 
-						std::min(chunk_size.second, static_cast<size_t>(end_iter_pair.second - start_iter_pair.second))),
-			m_loopFunc(std::move(loop_func)), m_numThreads(0)
+			Work(true),
+			m_startIter(start_iter_pair), m_endIter(end_iter_pair),
+			m_chunkSize(std::max<size_t>(std::min(chunk_size.first, end_iter_pair.first - start_iter_pair.first), 1),
+						std::max<size_t>(std::min(chunk_size.second, end_iter_pair.second - start_iter_pair.second), 1)),
+			m_chunksPerRow((end_iter_pair.first - start_iter_pair.first + m_chunkSize.first - 1) / m_chunkSize.first),
+			m_chunksCount(m_chunksPerRow * ((end_iter_pair.second - start_iter_pair.second + m_chunkSize.second - 1) / m_chunkSize.second)),
+			m_loopFunc(std::move(loop_func)),
+			m_nextChunk(0), m_remainingChunks(m_chunksCount)
 		{
-			/*m_chunkSize = {
-				std::min(chunk_size.first, static_cast<size_t>(end_iter_pair.first - start_iter_pair.first)), 
-				std::min(chunk_size.second, static_cast<size_t>(end_iter_pair.second - start_iter_pair.second))
-			};*/
-
-			//m_chunkSize(std::min(chunk_size, static_cast<size_t>(end_iter - start_iter))), 
+			if (m_chunksCount == 0)
+				SetFinished();
 		}
 
 		void Execute() override
 		{
-			std::unique_lock<std::mutex> lock (loopMutex);
-			while (m_currentIter != m_endIter)
+			while (true)
 			{
-				iterator startIt = m_currentIter;
-				iterator endIt = iterator{
-					std::min<size_t>(m_currentIter.first + m_chunkSize.first, m_endIter.first),
-					std::min<size_t>(m_currentIter.second + m_chunkSize.second, m_endIter.second)
+				// Claim the next 2D chunk. Chunks are numbered row by row.
+				const size_t chunk_idx = m_nextChunk.fetch_add(1, std::memory_order_relaxed);
+				if (chunk_idx >= m_chunksCount)
+					break;
+
+				const iterator start_it {
+					m_startIter.first + (chunk_idx % m_chunksPerRow) * m_chunkSize.first,
+					m_startIter.second + (chunk_idx / m_chunksPerRow) * m_chunkSize.second
+				};
+				const iterator end_it {
+					std::min(start_it.first + m_chunkSize.first, m_endIter.first),
+					std::min(start_it.second + m_chunkSize.second, m_endIter.second)
 				};
-				m_currentIter = endIt;
-
-				m_numThreads++;
-
-				lock.unlock();
 
-				for (size_t vert_it = startIt.second; vert_it < endIt.second; ++vert_it)
+				for (size_t vert_it = start_it.second; vert_it < end_it.second; ++vert_it)
 				{
-					for (size_t hor_it = startIt.first; hor_it < endIt.first; ++hor_it)
+					for (size_t hor_it = start_it.first; hor_it < end_it.first; ++hor_it)
 					{
 						m_loopFunc({hor_it, vert_it});
 					}
 				}
 
-				lock.lock();
-
-				m_numThreads--;
-
-				// The work is only finished once the number of iterations ends,
-				// and there is no more threads working on any of other iterations.
-				// (Note that the thread that picked the last iterations might finish before a
-				// thread that picked previous loop iterations, thus requiring the check for the number of threads working before finishing.)
-				if (m_currentIter == m_endIter && m_numThreads == 0)
-					m_finished = true;
+				// The work is only finished once every chunk is computed.
+				if (m_remainingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					SetFinished();
+				else if (ShouldYield())
+					break;
 			}
 		}
 
 		bool WillFinishOnNextExecute() override
 		{
-			iterator curr_it;
-			{
-				std::scoped_lock<std::mutex> lock (loopMutex);
-				curr_it = m_currentIter;
-			}
-			const iterator next_it = iterator{
-					std::min<size_t>((curr_it.first + m_chunkSize.first), m_endIter.first),
-					std::min<size_t>((curr_it.second + m_chunkSize.second), m_endIter.second)
-				};
-			return next_it == m_endIter;
+			return m_nextChunk.load(std::memory_order_relaxed) + 1 >= m_chunksCount;
 		}
 
 	private:
-		std::pair<size_t,size_t> m_currentIter;
+		const std::pair<size_t,size_t> m_startIter;
 		const std::pair<size_t,size_t> m_endIter;
 		const std::pair<size_t,size_t> m_chunkSize;
-		size_t m_numThreads;
-		std::mutex loopMutex;
+		const size_t m_chunksPerRow;
+		const size_t m_chunksCount;
 		Loop2DFunc m_loopFunc;
-	};  
+		std::atomic<size_t> m_nextChunk;
+		std::atomic<size_t> m_remainingChunks;
+	};
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+#ifndef BRR_WorkStealingDeque_h
+#define BRR_WorkStealingDeque_h
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace brr::thread
+{
+	/**
+	 * \brief Lock-free Chase-Lev work-stealing deque.
+	 *
+	 * The owner thread pushes and pops items at the bottom of the deque (LIFO), while any other thread can steal
+	 * items from the top (FIFO). The internal ring buffer grows when full. Old buffers are only released when the
+	 * deque is destroyed, since a concurrent thief may still be reading from them.
+	 *
+	 * Implementation follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al., 2013).
+	 * \tparam T Trivially copyable item type (usually a pointer).
+	 */
+	template <typename T>
+	class WorkStealingDeque
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque items must be trivially copyable.");
+	public:
+		static constexpr int64_t DEFAULT_CAPACITY = 1024;
+
+		// Not explicit, so arrays of deques can be value-initialized.
+		WorkStealingDeque() : WorkStealingDeque(DEFAULT_CAPACITY) {}
+
+		explicit WorkStealingDeque(int64_t initial_capacity);
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		~WorkStealingDeque();
+
+		/**
+		 * \brief Push an item at the bottom of the deque. Must only be called by the owner thread.
+		 */
+		void Push(T item);
+
+		/**
+		 * \brief Pop the last pushed item from the bottom of the deque. Must only be called by the owner thread.
+		 * \return The popped item, or an empty optional if the deque is empty.
+		 */
+		std::optional<T> Pop();
+
+		/**
+		 * \brief Steal the oldest item from the top of the deque. Can be called by any thread.
+		 * \return The stolen item, or an empty optional if the deque is empty or the steal lost a race.
+		 */
+		std::optional<T> Steal();
+
+		[[nodiscard]] bool Empty() const { return Size() == 0; }
+
+		[[nodiscard]] size_t Size() const
+		{
+			const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+			const int64_t top = m_top.load(std::memory_order_relaxed);
+			return static_cast<size_t>(bottom >= top ? bottom - top : 0);
+		}
+
+	private:
+		struct RingBuffer
+		{
+			explicit RingBuffer(int64_t capacity)
+			: m_capacity(capacity), m_mask(capacity - 1), m_items(new std::atomic<T>[capacity])
+			{
+				assert((capacity & (capacity - 1)) == 0 && "RingBuffer capacity must be a power of two.");
+			}
+
+			[[nodiscard]] int64_t Capacity() const { return m_capacity; }
+
+			void Store(int64_t index, T item) { m_items[index & m_mask].store(item, std::memory_order_relaxed); }
+			[[nodiscard]] T Load(int64_t index) const { return m_items[index & m_mask].load(std::memory_order_relaxed); }
+
+			RingBuffer* Grow(int64_t bottom, int64_t top) const
+			{
+				RingBuffer* new_buffer = new RingBuffer(m_capacity * 2);
+				for (int64_t idx = top; idx != bottom; ++idx)
+				{
+					new_buffer->Store(idx, Load(idx));
+				}
+				return new_buffer;
+			}
+
+		private:
+			const int64_t m_capacity;
+			const int64_t m_mask;
+			std::unique_ptr<std::atomic<T>[]> m_items;
+		};
+
+		alignas(64) std::atomic<int64_t> m_top;
+		alignas(64) std::atomic<int64_t> m_bottom;
+		alignas(64) std::atomic<RingBuffer*> m_buffer;
+
+		// Buffers replaced by a grow operation. Only accessed by the owner thread.
+		std::vector<std::unique_ptr<RingBuffer>> m_retiredBuffers;
+	};
+
+	/******************
+	 * Implementation *
+	 ******************/
+
+	template <typename T>
+	WorkStealingDeque<T>::WorkStealingDeque(int64_t initial_capacity)
+	: m_top(0), m_bottom(0), m_buffer(new RingBuffer(initial_capacity))
+	{
+	}
+
+	template <typename T>
+	WorkStealingDeque<T>::~WorkStealingDeque()
+	{
+		delete m_buffer.load(std::memory_order_relaxed);
+	}
+
+	template <typename T>
+	void WorkStealingDeque<T>::Push(T item)
+	{
+		const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_top.load(std::memory_order_acquire);
+		RingBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+
+		if (bottom - top > buffer->Capacity() - 1)
+		{
+			// Buffer is full. Grow it, keeping the old one alive for thieves that may still be reading it.
+			RingBuffer* new_buffer = buffer->Grow(bottom, top);
+			m_retiredBuffers.emplace_back(buffer);
+			m_buffer.store(new_buffer, std::memory_order_release);
+			buffer = new_buffer;
+		}
+
+		buffer->Store(bottom, item);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	template <typename T>
+	std::optional<T> WorkStealingDeque<T>::Pop()
+	{
+		const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		RingBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// Deque was empty. Restore bottom.
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return std::nullopt;
+		}
+
+		T item = buffer->Load(bottom);
+		if (top == bottom)
+		{
+			// Last item in the deque. Race against thieves for it.
+			const bool won_race = m_top.compare_exchange_strong(top, top + 1,
+			                                                    std::memory_order_seq_cst,
+			                                                    std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			if (!won_race)
+			{
+				return std::nullopt;
+			}
+		}
+		return item;
+	}
+
+	template <typename T>
+	std::optional<T> WorkStealingDeque<T>::Steal()
+	{
+		int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom)
+		{
+			return std::nullopt;
+		}
+
+		RingBuffer* buffer = m_buffer.load(std::memory_order_acquire);
+		T item = buffer->Load(top);
+		if (!m_top.compare_exchange_strong(top, top + 1,
+		                                   std::memory_order_seq_cst,
+		                                   std::memory_order_relaxed))
+		{
+			return std::nullopt;
+		}
+		return item;
+	}
+}
+
+#endif
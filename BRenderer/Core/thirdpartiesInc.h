@@ -13,6 +13,7 @@
 #include "glm/gtx/string_cast.hpp"
 
 #include "entt/entity/registry.hpp"
+#include "entt/entity/observer.hpp"
 
 #undef near
 #undef far
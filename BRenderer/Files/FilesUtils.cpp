@@ -21,4 +21,11 @@ namespace brr::files
 
 		return buffer;
 	}
+
+	thread::Task<std::vector<char>> ReadFileAsync(std::string file_path)
+	{
+		// 'file_path' lives in the coroutine frame, so it can be captured by reference.
+		std::vector<char> buffer = co_await thread::RunAsync([&file_path] { return ReadFile(file_path); }, thread::WorkPriority::BlockingIO);
+		co_return buffer;
+	}
 }
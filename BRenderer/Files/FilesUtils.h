@@ -1,5 +1,7 @@
 #ifndef BRR_FILESUTILS_H
 #define BRR_FILESUTILS_H
+#include <Core/Threading/Task.h>
+
 #include <string>
 #include <vector>
 
@@ -8,6 +10,11 @@ namespace brr::files
 
 	std::vector<char> ReadFile(const std::string& file_path);
 
+	/**
+	 * \brief Read a file on a thread of the default ThreadPool. The awaiting coroutine resumes as described in 'thread::RunAsync'.
+	 */
+	thread::Task<std::vector<char>> ReadFileAsync(std::string file_path);
+
 }
 
 #endif
\ No newline at end of file
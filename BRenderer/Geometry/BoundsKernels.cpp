@@ -0,0 +1,72 @@
+#include "BoundsKernels.h"
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BRR_BOUNDS_KERNEL_SSE
+#endif
+
+namespace brr
+{
+	// The SIMD kernel loads the position with the following float, so both must be contiguous.
+	static_assert(offsetof(Vertex3, u) == sizeof(glm::vec3), "Vertex3 position must be followed by a float.");
+
+	AABBB ComputeVerticesBounds(const Vertex3* vertices, size_t count)
+	{
+#if defined(BRR_BOUNDS_KERNEL_SSE)
+		if (count == 0)
+		{
+		    return {};
+		}
+
+		// Two pairs of accumulators, so consecutive vertices don't depend on each other.
+		const __m128 first_position = _mm_loadu_ps(&vertices[0].pos.x);
+		__m128 min_even = first_position, max_even = first_position;
+		__m128 min_odd  = first_position, max_odd  = first_position;
+
+		size_t index = 1;
+		for (; index + 2 <= count; index += 2)
+		{
+			const __m128 even_position = _mm_loadu_ps(&vertices[index].pos.x);
+			const __m128 odd_position  = _mm_loadu_ps(&vertices[index + 1].pos.x);
+			min_even = _mm_min_ps(min_even, even_position);
+			max_even = _mm_max_ps(max_even, even_position);
+			min_odd  = _mm_min_ps(min_odd, odd_position);
+			max_odd  = _mm_max_ps(max_odd, odd_position);
+		}
+		if (index < count)
+		{
+			const __m128 last_position = _mm_loadu_ps(&vertices[index].pos.x);
+			min_even = _mm_min_ps(min_even, last_position);
+			max_even = _mm_max_ps(max_even, last_position);
+		}
+
+		// Fourth lane holds the 'u' coordinate, and is ignored.
+		alignas(16) float min_pos[4];
+		alignas(16) float max_pos[4];
+		_mm_store_ps(min_pos, _mm_min_ps(min_even, min_odd));
+		_mm_store_ps(max_pos, _mm_max_ps(max_even, max_odd));
+		return {glm::vec3(min_pos[0], min_pos[1], min_pos[2]), glm::vec3(max_pos[0], max_pos[1], max_pos[2])};
+#else
+		return ComputeVerticesBoundsScalar(vertices, count);
+#endif
+	}
+
+	AABBB ComputeVerticesBoundsScalar(const Vertex3* vertices, size_t count)
+	{
+		if (count == 0)
+		{
+		    return {};
+		}
+
+		glm::vec3 min_pos = vertices[0].pos;
+		glm::vec3 max_pos = vertices[0].pos;
+		for (size_t index = 1; index < count; index++)
+		{
+			min_pos = glm::min(min_pos, vertices[index].pos);
+			max_pos = glm::max(max_pos, vertices[index].pos);
+		}
+		return {min_pos, max_pos};
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef BRR_BOUNDSKERNELS_H
+#define BRR_BOUNDSKERNELS_H
+#include <Geometry/Geometry.h>
+
+#include <cstddef>
+
+namespace brr
+{
+	/**
+	 * \brief Compute the bounding box of the positions of 'vertices'. Returns an invalid box if 'count' is 0.
+	 *
+	 * Uses SSE2 when enabled at compile time, and the scalar kernel otherwise.
+	 */
+	AABBB ComputeVerticesBounds(const Vertex3* vertices, size_t count);
+
+	/**
+	 * \brief Scalar version of ComputeVerticesBounds, used as fallback and as reference for the SIMD kernel.
+	 */
+	AABBB ComputeVerticesBoundsScalar(const Vertex3* vertices, size_t count);
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "Frustum.h"
+
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define BRR_FRUSTUM_KERNEL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BRR_FRUSTUM_KERNEL_SSE
+#endif
+
+namespace brr
+{
+	namespace
+	{
+		/**
+		 * \brief Frustum planes stored as separate streams, one plane per lane, so each box is tested against all
+		 *        planes at once. Padded to 8 planes by repeating the last plane.
+		 */
+		struct FrustumPlaneStreams
+		{
+			static constexpr size_t PADDED_PLANES_COUNT = 8;
+
+			explicit FrustumPlaneStreams(const Frustum& frustum)
+			{
+				for (size_t lane = 0; lane < PADDED_PLANES_COUNT; lane++)
+				{
+					const glm::vec4& plane = frustum.planes[std::min(lane, Frustum::PLANES_COUNT - 1)];
+					normal_x[lane]     = plane.x;
+					normal_y[lane]     = plane.y;
+					normal_z[lane]     = plane.z;
+					distance[lane]     = plane.w;
+					abs_normal_x[lane] = std::abs(plane.x);
+					abs_normal_y[lane] = std::abs(plane.y);
+					abs_normal_z[lane] = std::abs(plane.z);
+				}
+			}
+
+			alignas(32) float normal_x[PADDED_PLANES_COUNT];
+			alignas(32) float normal_y[PADDED_PLANES_COUNT];
+			alignas(32) float normal_z[PADDED_PLANES_COUNT];
+			alignas(32) float distance[PADDED_PLANES_COUNT];
+			alignas(32) float abs_normal_x[PADDED_PLANES_COUNT];
+			alignas(32) float abs_normal_y[PADDED_PLANES_COUNT];
+			alignas(32) float abs_normal_z[PADDED_PLANES_COUNT];
+		};
+
+		/**
+		 * \brief A box is outside the frustum when its point nearest to the inside of a plane is behind that plane.
+		 *        Operations are done in the same order in every kernel.
+		 */
+		bool IsBoxVisibleScalar(const FrustumPlaneStreams& planes, const glm::vec3& center, const glm::vec3& extent)
+		{
+			for (size_t plane = 0; plane < Frustum::PLANES_COUNT; plane++)
+			{
+				const float distance = planes.normal_x[plane] * center.x + planes.normal_y[plane] * center.y
+				                     + planes.normal_z[plane] * center.z + planes.distance[plane];
+				const float radius   = planes.abs_normal_x[plane] * extent.x + planes.abs_normal_y[plane] * extent.y
+				                     + planes.abs_normal_z[plane] * extent.z;
+				if (distance + radius < 0.0f)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+#if defined(BRR_FRUSTUM_KERNEL_SSE)
+		bool IsBoxVisibleSimd(const FrustumPlaneStreams& planes, const glm::vec3& center, const glm::vec3& extent)
+		{
+			const __m128 center_x = _mm_set1_ps(center.x);
+			const __m128 center_y = _mm_set1_ps(center.y);
+			const __m128 center_z = _mm_set1_ps(center.z);
+			const __m128 extent_x = _mm_set1_ps(extent.x);
+			const __m128 extent_y = _mm_set1_ps(extent.y);
+			const __m128 extent_z = _mm_set1_ps(extent.z);
+			const __m128 zero     = _mm_setzero_ps();
+
+			__m128 outside = zero;
+			for (size_t first_plane = 0; first_plane < FrustumPlaneStreams::PADDED_PLANES_COUNT; first_plane += 4)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_load_ps(planes.normal_x + first_plane), center_x),
+				                             _mm_mul_ps(_mm_load_ps(planes.normal_y + first_plane), center_y));
+				distance        = _mm_add_ps(distance, _mm_mul_ps(_mm_load_ps(planes.normal_z + first_plane), center_z));
+				distance        = _mm_add_ps(distance, _mm_load_ps(planes.distance + first_plane));
+
+				__m128 radius = _mm_add_ps(_mm_mul_ps(_mm_load_ps(planes.abs_normal_x + first_plane), extent_x),
+				                           _mm_mul_ps(_mm_load_ps(planes.abs_normal_y + first_plane), extent_y));
+				radius        = _mm_add_ps(radius, _mm_mul_ps(_mm_load_ps(planes.abs_normal_z + first_plane), extent_z));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+			return _mm_movemask_ps(outside) == 0;
+		}
+#elif defined(BRR_FRUSTUM_KERNEL_AVX)
+		bool IsBoxVisibleSimd(const FrustumPlaneStreams& planes, const glm::vec3& center, const glm::vec3& extent)
+		{
+			__m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(planes.normal_x), _mm256_set1_ps(center.x)),
+			                                _mm256_mul_ps(_mm256_load_ps(planes.normal_y), _mm256_set1_ps(center.y)));
+			distance        = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_load_ps(planes.normal_z), _mm256_set1_ps(center.z)));
+			distance        = _mm256_add_ps(distance, _mm256_load_ps(planes.distance));
+
+			__m256 radius = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(planes.abs_normal_x), _mm256_set1_ps(extent.x)),
+			                              _mm256_mul_ps(_mm256_load_ps(planes.abs_normal_y), _mm256_set1_ps(extent.y)));
+			radius        = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_load_ps(planes.abs_normal_z), _mm256_set1_ps(extent.z)));
+
+			const __m256 outside = _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ);
+			return _mm256_movemask_ps(outside) == 0;
+		}
+#endif
+
+		template <bool UseSimd>
+		size_t CullAABBsImpl(const Frustum& frustum, std::span<const AABBB> bounds, uint8_t* out_visible)
+		{
+			const FrustumPlaneStreams planes (frustum);
+
+			size_t visible_count = 0;
+			for (size_t index = 0; index < bounds.size(); index++)
+			{
+				const AABBB& aabb = bounds[index];
+				bool visible = true;
+				if (aabb.IsValid())
+				{
+					const glm::vec3 center = (aabb.GetMaxPos() + aabb.GetMinPos()) * 0.5f;
+					const glm::vec3 extent = (aabb.GetMaxPos() - aabb.GetMinPos()) * 0.5f;
+#if defined(BRR_FRUSTUM_KERNEL_SSE) || defined(BRR_FRUSTUM_KERNEL_AVX)
+					if constexpr (UseSimd)
+					{
+						visible = IsBoxVisibleSimd(planes, center, extent);
+					}
+					else
+#endif
+					{
+						visible = IsBoxVisibleScalar(planes, center, extent);
+					}
+				}
+				out_visible[index] = visible;
+				visible_count     += visible;
+			}
+			return visible_count;
+		}
+	}
+
+	Frustum Frustum::FromProjectionView(const glm::mat4& projection_view)
+	{
+		// Clip space points inside the frustum satisfy -w <= x <= w, -w <= y <= w and 0 <= z <= w.
+		const glm::vec4 row_x = glm::row(projection_view, 0);
+		const glm::vec4 row_y = glm::row(projection_view, 1);
+		const glm::vec4 row_z = glm::row(projection_view, 2);
+		const glm::vec4 row_w = glm::row(projection_view, 3);
+
+		Frustum frustum;
+		frustum.planes = {row_w + row_x, row_w - row_x, row_w + row_y, row_w - row_y, row_z, row_w - row_z};
+		for (glm::vec4& plane : frustum.planes)
+		{
+			const float normal_length = glm::length(glm::vec3(plane));
+			if (normal_length > 0.0f)
+			{
+				plane /= normal_length;
+			}
+		}
+		return frustum;
+	}
+
+	Frustum::Containment Frustum::Classify(const AABBB& aabb, uint8_t& planes_mask) const
+	{
+		const glm::vec3 center = (aabb.GetMaxPos() + aabb.GetMinPos()) * 0.5f;
+		const glm::vec3 extent = (aabb.GetMaxPos() - aabb.GetMinPos()) * 0.5f;
+
+		uint8_t intersected_planes = 0;
+		for (size_t plane_index = 0; plane_index < PLANES_COUNT; plane_index++)
+		{
+			const uint8_t plane_bit = 1u << plane_index;
+			if (!(planes_mask & plane_bit))
+			{
+			    continue;
+			}
+
+			const glm::vec4& plane = planes[plane_index];
+			const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+			const float radius   = glm::dot(glm::abs(glm::vec3(plane)), extent);
+			if (distance + radius < 0.0f)
+			{
+			    return Containment::Outside;
+			}
+			if (distance - radius < 0.0f)
+			{
+			    intersected_planes |= plane_bit;
+			}
+		}
+
+		planes_mask = intersected_planes;
+		return intersected_planes == 0 ? Containment::Inside : Containment::Intersecting;
+	}
+
+	size_t CullAABBs(const Frustum& frustum, std::span<const AABBB> bounds, uint8_t* out_visible)
+	{
+		return CullAABBsImpl<true>(frustum, bounds, out_visible);
+	}
+
+	size_t CullAABBsScalar(const Frustum& frustum, std::span<const AABBB> bounds, uint8_t* out_visible)
+	{
+		return CullAABBsImpl<false>(frustum, bounds, out_visible);
+	}
+}
@@ -0,0 +1,67 @@
+#ifndef BRR_FRUSTUM_H
+#define BRR_FRUSTUM_H
+#include <Core/thirdpartiesInc.h>
+#include <Geometry/Geometry.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace brr
+{
+	/**
+	 * \brief Planes of a view frustum, stored as (normal, distance) with normals pointing inside the frustum.
+	 *        A point 'p' is inside the plane when 'dot(normal, p) + distance >= 0'.
+	 */
+	struct Frustum
+	{
+		static constexpr size_t PLANES_COUNT = 6;
+
+		/**
+		 * \brief Extract the left, right, bottom, top, near and far planes from a projection-view matrix,
+		 *        with depth in the range [0, 1].
+		 */
+		static Frustum FromProjectionView(const glm::mat4& projection_view);
+
+		static constexpr uint8_t ALL_PLANES_MASK = (1u << PLANES_COUNT) - 1;
+
+		enum class Containment : uint8_t
+		{
+			Outside,
+			Intersecting,
+			Inside
+		};
+
+		/**
+		 * \brief Classify a valid bounding box against the planes in 'planes_mask'.
+		 * \param planes_mask Planes to test, one bit per plane. Children of a box only need to be tested against the
+		 *        planes their parent intersects, so the mask of those planes is written back to 'planes_mask'.
+		 */
+		Containment Classify(const AABBB& aabb, uint8_t& planes_mask) const;
+
+		// Default planes contain every point.
+		std::array<glm::vec4, PLANES_COUNT> planes
+		{
+			glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+			glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)
+		};
+	};
+
+	/**
+	 * \brief Test each bounding box against the frustum, writing 1 to 'out_visible[i]' if 'bounds[i]' is inside or
+	 *        intersects the frustum, and 0 otherwise. Invalid bounding boxes are always visible.
+	 *
+	 * The test is conservative: boxes outside the frustum but not fully behind one of its planes are visible.
+	 * Uses the widest SIMD instruction set enabled at compile time (AVX or SSE2), and the scalar kernel otherwise.
+	 * \return Number of visible bounding boxes.
+	 */
+	size_t CullAABBs(const Frustum& frustum, std::span<const AABBB> bounds, uint8_t* out_visible);
+
+	/**
+	 * \brief Scalar version of CullAABBs, used as fallback and as reference for the SIMD kernels.
+	 */
+	size_t CullAABBsScalar(const Frustum& frustum, std::span<const AABBB> bounds, uint8_t* out_visible);
+}
+
+#endif
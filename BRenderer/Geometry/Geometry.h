@@ -2,6 +2,8 @@
 #define BRR_GEOMETRY_H
 #include <Core/thirdpartiesInc.h>
 
+#include <limits>
+
 namespace brr
 {
 	struct Vertex2_PosColor
@@ -41,13 +43,24 @@ namespace brr
 	class AABBB
 	{
 	public:
+		// Default bounding box is empty, and therefore invalid.
+		AABBB() = default;
+
+		AABBB(const glm::vec3& min_pos, const glm::vec3& max_pos)
+		: m_min_pos(min_pos),
+		  m_max_pos(max_pos)
+		{}
+
 		const glm::vec3& GetMinPos() const { return m_min_pos; }
 
 		const glm::vec3& GetMaxPos() const { return m_max_pos; }
 
+		/**
+		 * \brief A bounding box is valid if it contains at least one point. Flat boxes are valid.
+		 */
 		bool IsValid() const
 		{
-		    return !glm::any(glm::lessThanEqual(m_max_pos, m_min_pos));
+		    return glm::all(glm::lessThanEqual(m_min_pos, m_max_pos));
 		}
 
 		bool IsPointInside(const glm::vec3& point) const
@@ -71,10 +84,41 @@ namespace brr
 			return r <= dist;
 		}
 
+		/**
+		 * \brief Grow the bounding box to contain 'other'. Invalid boxes are ignored.
+		 */
+		void Expand(const AABBB& other)
+		{
+			if (other.IsValid())
+			{
+			    m_min_pos = glm::min(m_min_pos, other.m_min_pos);
+				m_max_pos = glm::max(m_max_pos, other.m_max_pos);
+			}
+		}
+
+		/**
+		 * \brief Get the smallest axis aligned box containing this box transformed by 'matrix'.
+		 */
+		AABBB Transformed(const glm::mat4& matrix) const
+		{
+			if (!IsValid())
+			{
+			    return *this;
+			}
+
+			const glm::vec3 center = glm::vec3(matrix * glm::vec4((m_max_pos + m_min_pos) * 0.5f, 1.0f));
+			const glm::vec3 half_extent = (m_max_pos - m_min_pos) * 0.5f;
+			// Extent of the transformed box along each axis is the extent projected by the absolute matrix.
+			const glm::vec3 new_half_extent = glm::abs(glm::vec3(matrix[0])) * half_extent.x
+			                                + glm::abs(glm::vec3(matrix[1])) * half_extent.y
+			                                + glm::abs(glm::vec3(matrix[2])) * half_extent.z;
+			return {center - new_half_extent, center + new_half_extent};
+		}
+
 	private:
 
-		glm::vec3 m_min_pos;
-		glm::vec3 m_max_pos;
+		glm::vec3 m_min_pos { std::numeric_limits<float>::max() };
+		glm::vec3 m_max_pos { std::numeric_limits<float>::lowest() };
 	};
 
 	using Vertex3 = Vertex3_PosUvNormal;
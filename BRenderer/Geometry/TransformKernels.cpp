@@ -0,0 +1,186 @@
+#include "TransformKernels.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define BRR_TRS_KERNEL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BRR_TRS_KERNEL_SSE
+#endif
+
+namespace brr
+{
+	namespace
+	{
+		/**
+		 * \brief Compute the 3x3 part of the TRS matrices of a batch of elements, one element per lane.
+		 *        Operations are done in the same order as glm's mat3_cast followed by scale.
+		 */
+		template <typename Lane>
+		struct TRSColumns
+		{
+			TRSColumns(const TRSStreams& streams, size_t index)
+			{
+				const Lane qx = Lane::Load(streams.rotation_x + index);
+				const Lane qy = Lane::Load(streams.rotation_y + index);
+				const Lane qz = Lane::Load(streams.rotation_z + index);
+				const Lane qw = Lane::Load(streams.rotation_w + index);
+				const Lane sx = Lane::Load(streams.scale_x + index);
+				const Lane sy = Lane::Load(streams.scale_y + index);
+				const Lane sz = Lane::Load(streams.scale_z + index);
+
+				const Lane one = Lane::Set(1.0f);
+				const Lane two = Lane::Set(2.0f);
+
+				const Lane qxx = qx * qx;
+				const Lane qyy = qy * qy;
+				const Lane qzz = qz * qz;
+				const Lane qxz = qx * qz;
+				const Lane qxy = qx * qy;
+				const Lane qyz = qy * qz;
+				const Lane qwx = qw * qx;
+				const Lane qwy = qw * qy;
+				const Lane qwz = qw * qz;
+
+				column[0][0] = (one - two * (qyy + qzz)) * sx;
+				column[0][1] = (two * (qxy + qwz)) * sx;
+				column[0][2] = (two * (qxz - qwy)) * sx;
+
+				column[1][0] = (two * (qxy - qwz)) * sy;
+				column[1][1] = (one - two * (qxx + qzz)) * sy;
+				column[1][2] = (two * (qyz + qwx)) * sy;
+
+				column[2][0] = (two * (qxz + qwy)) * sz;
+				column[2][1] = (two * (qyz - qwx)) * sz;
+				column[2][2] = (one - two * (qxx + qyy)) * sz;
+
+				column[3][0] = Lane::Load(streams.position_x + index);
+				column[3][1] = Lane::Load(streams.position_y + index);
+				column[3][2] = Lane::Load(streams.position_z + index);
+			}
+
+			Lane column[4][3];
+		};
+
+#if defined(BRR_TRS_KERNEL_SSE) || defined(BRR_TRS_KERNEL_AVX)
+		struct Lane4
+		{
+			static constexpr size_t WIDTH = 4;
+
+			static Lane4 Load(const float* values) { return {_mm_loadu_ps(values)}; }
+			static Lane4 Set(float value) { return {_mm_set1_ps(value)}; }
+
+			Lane4 operator+(Lane4 other) const { return {_mm_add_ps(value, other.value)}; }
+			Lane4 operator-(Lane4 other) const { return {_mm_sub_ps(value, other.value)}; }
+			Lane4 operator*(Lane4 other) const { return {_mm_mul_ps(value, other.value)}; }
+
+			__m128 value;
+		};
+
+		/**
+		 * \brief Transpose the x, y and z rows of a column of 4 matrices, and store the column in each of the matrices.
+		 */
+		void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, glm::mat4* out_matrices, int column_index)
+		{
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(&out_matrices[0][column_index][0], x);
+			_mm_storeu_ps(&out_matrices[1][column_index][0], y);
+			_mm_storeu_ps(&out_matrices[2][column_index][0], z);
+			_mm_storeu_ps(&out_matrices[3][column_index][0], w);
+		}
+
+		void StoreMatrices(__m128 (&columns)[4][3], glm::mat4* out_matrices)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			StoreColumn(columns[0][0], columns[0][1], columns[0][2], zero, out_matrices, 0);
+			StoreColumn(columns[1][0], columns[1][1], columns[1][2], zero, out_matrices, 1);
+			StoreColumn(columns[2][0], columns[2][1], columns[2][2], zero, out_matrices, 2);
+			StoreColumn(columns[3][0], columns[3][1], columns[3][2], _mm_set1_ps(1.0f), out_matrices, 3);
+		}
+
+		void StoreMatrices(const TRSColumns<Lane4>& trs_columns, glm::mat4* out_matrices)
+		{
+			__m128 columns[4][3];
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 3; row++)
+				{
+					columns[column][row] = trs_columns.column[column][row].value;
+				}
+			}
+			StoreMatrices(columns, out_matrices);
+		}
+#endif
+
+#if defined(BRR_TRS_KERNEL_AVX)
+		struct Lane8
+		{
+			static constexpr size_t WIDTH = 8;
+
+			static Lane8 Load(const float* values) { return {_mm256_loadu_ps(values)}; }
+			static Lane8 Set(float value) { return {_mm256_set1_ps(value)}; }
+
+			Lane8 operator+(Lane8 other) const { return {_mm256_add_ps(value, other.value)}; }
+			Lane8 operator-(Lane8 other) const { return {_mm256_sub_ps(value, other.value)}; }
+			Lane8 operator*(Lane8 other) const { return {_mm256_mul_ps(value, other.value)}; }
+
+			__m256 value;
+		};
+
+		void StoreMatrices(const TRSColumns<Lane8>& trs_columns, glm::mat4* out_matrices)
+		{
+			// Each half of the lanes is stored as 4 matrices.
+			__m128 low_columns[4][3];
+			__m128 high_columns[4][3];
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 3; row++)
+				{
+					low_columns[column][row]  = _mm256_castps256_ps128(trs_columns.column[column][row].value);
+					high_columns[column][row] = _mm256_extractf128_ps(trs_columns.column[column][row].value, 1);
+				}
+			}
+			StoreMatrices(low_columns, out_matrices);
+			StoreMatrices(high_columns, out_matrices + 4);
+		}
+#endif
+
+		template <typename Lane>
+		size_t ComposeTRSMatricesSimd(const TRSStreams& streams, size_t begin, size_t end, glm::mat4* out_matrices)
+		{
+			size_t index = begin;
+			for (; index + Lane::WIDTH <= end; index += Lane::WIDTH)
+			{
+				StoreMatrices(TRSColumns<Lane>(streams, index), out_matrices + (index - begin));
+			}
+			return index;
+		}
+	}
+
+	void ComposeTRSMatrices(const TRSStreams& streams, size_t begin, size_t end, glm::mat4* out_matrices)
+	{
+		size_t index = begin;
+#if defined(BRR_TRS_KERNEL_AVX)
+		index = ComposeTRSMatricesSimd<Lane8>(streams, index, end, out_matrices);
+#endif
+#if defined(BRR_TRS_KERNEL_SSE) || defined(BRR_TRS_KERNEL_AVX)
+		index = ComposeTRSMatricesSimd<Lane4>(streams, index, end, out_matrices + (index - begin));
+#endif
+		// Remaining elements that don't fill a SIMD batch.
+		ComposeTRSMatricesScalar(streams, index, end, out_matrices + (index - begin));
+	}
+
+	void ComposeTRSMatricesScalar(const TRSStreams& streams, size_t begin, size_t end, glm::mat4* out_matrices)
+	{
+		for (size_t index = begin; index < end; index++)
+		{
+			const glm::fquat rotation (streams.rotation_w[index], streams.rotation_x[index],
+			                           streams.rotation_y[index], streams.rotation_z[index]);
+			const glm::vec3 scale (streams.scale_x[index], streams.scale_y[index], streams.scale_z[index]);
+
+			glm::mat4& matrix = out_matrices[index - begin];
+			matrix    = glm::scale(glm::mat4_cast(rotation), scale);
+			matrix[3] = glm::vec4(streams.position_x[index], streams.position_y[index], streams.position_z[index], 1.0f);
+		}
+	}
+}
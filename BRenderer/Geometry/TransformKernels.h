@@ -0,0 +1,41 @@
+#ifndef BRR_TRANSFORMKERNELS_H
+#define BRR_TRANSFORMKERNELS_H
+#include <Core/thirdpartiesInc.h>
+
+#include <cstddef>
+
+namespace brr
+{
+	/**
+	 * \brief Read-only view of translation, rotation and scale values stored as separate streams, one per component.
+	 */
+	struct TRSStreams
+	{
+		const float* position_x;
+		const float* position_y;
+		const float* position_z;
+		const float* rotation_x;
+		const float* rotation_y;
+		const float* rotation_z;
+		const float* rotation_w;
+		const float* scale_x;
+		const float* scale_y;
+		const float* scale_z;
+	};
+
+	/**
+	 * \brief Build the matrices 'translate * rotate * scale' of the elements [begin, end) of the streams,
+	 *        writing the matrix of element 'i' to 'out_matrices[i - begin]'.
+	 *
+	 * Uses the widest SIMD instruction set enabled at compile time (AVX or SSE2), and the scalar kernel otherwise.
+	 * Results match the glm path (mat4_cast, then scale) up to floating point contraction done by the compiler.
+	 */
+	void ComposeTRSMatrices(const TRSStreams& streams, size_t begin, size_t end, glm::mat4* out_matrices);
+
+	/**
+	 * \brief Scalar version of ComposeTRSMatrices, used as fallback and as reference for the SIMD kernels.
+	 */
+	void ComposeTRSMatricesScalar(const TRSStreams& streams, size_t begin, size_t end, glm::mat4* out_matrices);
+}
+
+#endif
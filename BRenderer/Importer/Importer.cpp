@@ -134,4 +134,25 @@ namespace brr
 
 		ConvertAssimpScene(assimp_scene, *scene, parent);
 	}
+
+	thread::Task<void> SceneImporter::LoadFileIntoSceneAsync(std::string path, Scene* scene, Entity parent)
+	{
+		// File reading and post-processing run on the ThreadPool background lane, so they don't delay frame work.
+		std::shared_ptr<Assimp::Importer> assimp_importer = co_await thread::RunAsync([&path]
+		{
+			std::shared_ptr<Assimp::Importer> importer = std::make_shared<Assimp::Importer>();
+			importer->ReadFile(path.c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
+			return importer;
+		}, thread::WorkPriority::Background);
+
+		// Scene mutation happens back on the main thread.
+		const aiScene* assimp_scene = assimp_importer->GetScene();
+		if (!assimp_scene)
+		{
+			BRR_LogError("Assimp could not load Scene. Assimp Error Code:\n{}", assimp_importer->GetErrorString());
+			co_return;
+		}
+
+		ConvertAssimpScene(assimp_scene, *scene, parent);
+	}
 }
@@ -2,6 +2,7 @@
 #define BRR_IMPORTER_H
 #include "Scene/Scene.h"
 #include "Scene/Entity.h"
+#include "Core/Threading/Task.h"
 
 namespace brr
 {
@@ -10,6 +11,12 @@ namespace brr
 	public:
 
 		static void LoadFileIntoScene(std::string path, Scene* scene, Entity parent = {});
+
+		/**
+		 * \brief Read and import the file on the ThreadPool, then convert it into the scene on the main thread.
+		 * Must be awaited or started from the main thread.
+		 */
+		static thread::Task<void> LoadFileIntoSceneAsync(std::string path, Scene* scene, Entity parent = {});
 	};
 }
 
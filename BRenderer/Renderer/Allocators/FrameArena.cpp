@@ -0,0 +1,100 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace brr::render
+{
+    FrameArena::FrameArena(size_t initial_block_size)
+    {
+        AddBlock(initial_block_size);
+    }
+
+    void* FrameArena::Allocate(size_t size, size_t alignment)
+    {
+        assert((alignment & (alignment - 1)) == 0 && "Alignment must be a power of two.");
+        if (size == 0)
+        {
+            size = 1;
+        }
+
+        if (size >= LARGE_ALLOCATION_SIZE)
+        {
+            Block& large_block = m_large_blocks.emplace_back();
+            // 'new std::byte[]' is aligned to at least 'alignof(std::max_align_t)'.
+            large_block.data   = std::make_unique_for_overwrite<std::byte[]>(size + alignment);
+            large_block.size   = size + alignment;
+            m_used_bytes      += size;
+
+            const uintptr_t address = reinterpret_cast<uintptr_t>(large_block.data.get());
+            return reinterpret_cast<void*>((address + alignment - 1) & ~(alignment - 1));
+        }
+
+        Block* block             = &m_blocks.back();
+        uintptr_t block_address  = reinterpret_cast<uintptr_t>(block->data.get());
+        size_t aligned_offset    = ((block_address + m_current_offset + alignment - 1) & ~(alignment - 1)) - block_address;
+
+        if (aligned_offset + size > block->size)
+        {
+            AddBlock(size + alignment);
+            block          = &m_blocks.back();
+            block_address  = reinterpret_cast<uintptr_t>(block->data.get());
+            aligned_offset = ((block_address + alignment - 1) & ~(alignment - 1)) - block_address;
+        }
+
+        m_current_offset = aligned_offset + size;
+        m_used_bytes    += size;
+        return block->data.get() + aligned_offset;
+    }
+
+    void* FrameArena::Copy(const void* data, size_t size)
+    {
+        if (!data || size == 0)
+        {
+            return nullptr;
+        }
+        void* copy = Allocate(size);
+        std::memcpy(copy, data, size);
+        return copy;
+    }
+
+    void FrameArena::Reset()
+    {
+        m_large_blocks.clear();
+
+        if (m_blocks.size() > 1)
+        {
+            // The frame didn't fit in a single block. Merge all of them, so the next frames fit in one block.
+            size_t total_size = 0;
+            for (const Block& block : m_blocks)
+            {
+                total_size += block.size;
+            }
+            m_blocks.clear();
+            AddBlock(total_size);
+        }
+
+        m_current_offset = 0;
+        m_used_bytes     = 0;
+    }
+
+    size_t FrameArena::Capacity() const
+    {
+        size_t capacity = 0;
+        for (const Block& block : m_blocks)
+        {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    void FrameArena::AddBlock(size_t min_size)
+    {
+        const size_t block_size = std::max(min_size, m_blocks.empty() ? min_size : m_blocks.back().size * 2);
+
+        Block& block = m_blocks.emplace_back();
+        block.data   = std::make_unique_for_overwrite<std::byte[]>(block_size);
+        block.size   = block_size;
+        m_current_offset = 0;
+    }
+}
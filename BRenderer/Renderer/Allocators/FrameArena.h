@@ -0,0 +1,107 @@
+#ifndef BRR_FRAMEARENA_H
+#define BRR_FRAMEARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace brr::render
+{
+    /**
+     * \brief Linear (bump-pointer) allocator for data that lives for a single frame.
+     *
+     * Allocations can't be freed individually. All of them are released at once with 'Reset'.
+     * When a frame needs more memory than the current block, new blocks are created. On the next 'Reset', the
+     * blocks are merged in a single block that fits the whole frame, so frames with similar usage don't allocate.
+     * Allocations bigger than 'LARGE_ALLOCATION_SIZE' get a dedicated block, that is released on 'Reset'.
+     */
+    class FrameArena
+    {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE    = 256 * 1024;
+        static constexpr size_t LARGE_ALLOCATION_SIZE = 1024 * 1024;
+
+        explicit FrameArena(size_t initial_block_size = DEFAULT_BLOCK_SIZE);
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        template <typename T>
+        T* Allocate(size_t count = 1)
+        {
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /**
+         * \brief Allocate a copy of 'size' bytes of 'data'.
+         * \return Pointer to the copy. nullptr if 'data' is nullptr or 'size' is zero.
+         */
+        void* Copy(const void* data, size_t size);
+
+        /**
+         * \brief Release every allocation. Memory previously returned by this arena must not be used anymore.
+         */
+        void Reset();
+
+        [[nodiscard]] size_t UsedBytes() const { return m_used_bytes; }
+        [[nodiscard]] size_t Capacity() const;
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size = 0;
+        };
+
+        void AddBlock(size_t min_size);
+
+        std::vector<Block> m_blocks;
+        std::vector<Block> m_large_blocks;
+        size_t m_current_offset = 0;
+        size_t m_used_bytes     = 0;
+    };
+
+    /**
+     * \brief Standard allocator that allocates from a FrameArena. Deallocation is a no-op.
+     */
+    template <typename T>
+    class FrameArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+
+        FrameArenaAllocator(FrameArena* arena) noexcept
+        : m_arena(arena)
+        {}
+
+        template <typename U>
+        FrameArenaAllocator(const FrameArenaAllocator<U>& other) noexcept
+        : m_arena(other.GetArena())
+        {}
+
+        T* allocate(size_t count)
+        {
+            return m_arena->Allocate<T>(count);
+        }
+
+        void deallocate(T*, size_t) noexcept
+        {}
+
+        [[nodiscard]] FrameArena* GetArena() const noexcept { return m_arena; }
+
+        template <typename U>
+        bool operator==(const FrameArenaAllocator<U>& other) const noexcept { return m_arena == other.GetArena(); }
+
+    private:
+        FrameArena* m_arena;
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define BRR_CMDLIST_H
 
 #include <Renderer/RenderDefs.h>
+#include <Renderer/Allocators/FrameArena.h>
 
 #include <array>
 #include <vector>
@@ -19,7 +20,8 @@ namespace brr::render::internal
     // SceneMaterialCmdList
     // SceneGeometryCmdList (vertex and index buffers)
 
-    template <typename T, typename Alloc = std::allocator<T>>
+    // Command lists allocate from the FrameArena of their RenderUpdateCmdGroup.
+    template <typename T, typename Alloc = FrameArenaAllocator<T>>
     using CmdList = std::vector<T, Alloc>;
 }
 
@@ -25,10 +25,6 @@ void ResourceCmdListExecutor::ExecuteResourceCommand(const ResourceCommand& reso
                                                               resource_command.texture_command.width,
                                                               resource_command.texture_command.height,
                                                               resource_command.texture_command.image_format);
-            if (resource_command.texture_command.image_data)
-            {
-                free(resource_command.texture_command.image_data);
-            }
             break;
         }
     case ResourceCommandType::DestroyTexture2D:
@@ -67,14 +63,6 @@ void ResourceCmdListExecutor::ExecuteResourceCommand(const ResourceCommand& reso
                                                            resource_command.surface_command.index_buffer,
                                                            resource_command.surface_command.index_buffer_size, 
                                                            resource_command.surface_command.material_id);
-            if (resource_command.surface_command.vertex_buffer)
-            {
-                free(resource_command.surface_command.vertex_buffer);
-            }
-            if (resource_command.surface_command.index_buffer)
-            {
-                free(resource_command.surface_command.index_buffer);
-            }
             break;
         }
     case ResourceCommandType::DestroySurface:
@@ -4,7 +4,7 @@ namespace brr::render::internal
 {
     void SceneRendererCmdListExecutor::ExecuteCmdList()
     {
-        for (auto& scene_cmds_pair : m_scene_cmd_list_map)
+        for (auto& scene_cmds_pair : m_scene_cmd_lists)
         {
             uint64_t scene_id             = scene_cmds_pair.first;
             SceneRenderer* scene_renderer = nullptr;
@@ -21,6 +21,8 @@ namespace brr::render::internal
                 {
                 case SceneRendererCmdType::CreateSceneRenderer:
                     {
+                        // Take ownership of the channel first, so it is released if the creation fails.
+                        std::unique_ptr<TransformChannel> transform_channel (scene_cmd.scene_command.transform_channel);
                         if (scene_renderer)
                         {
                             BRR_LogError("SceneRenderer command error. Command: CreateSceneRenderer. "
@@ -28,7 +30,7 @@ namespace brr::render::internal
                                          scene_id);
                             break;
                         }
-                        scene_renderer = scene_renderer_storage.CreateNew(scene_id, std::make_unique<SceneRenderer>());
+                        scene_renderer = scene_renderer_storage.CreateNew(scene_id, std::make_unique<SceneRenderer>(std::move(transform_channel)));
                         if (!scene_renderer)
                         {
                             BRR_LogError("SceneRenderer command failed. Command: CreateSceneRenderer. "
@@ -89,9 +91,22 @@ namespace brr::render::internal
         case SceneRendererCmdType::DestroyEntity:
             scene_renderer->DestroyEntity(scene_command.entity_command.entity_id);
             break;
-        case SceneRendererCmdType::UpdateEntityTransform:
-            scene_renderer->UpdateEntityTransform(scene_command.entity_command.entity_id,
-                                                  scene_command.entity_command.entity_transform);
+        case SceneRendererCmdType::DestroyEntities:
+            for (CameraID camera_id : std::span{scene_command.entities_command.camera_ids,
+                                                scene_command.entities_command.camera_count})
+            {
+                scene_renderer->DestroyCamera(camera_id);
+            }
+            for (LightID light_id : std::span{scene_command.entities_command.light_ids,
+                                              scene_command.entities_command.light_count})
+            {
+                scene_renderer->DestroyLight(light_id);
+            }
+            scene_renderer->DestroyEntities({scene_command.entities_command.entity_ids,
+                                             scene_command.entities_command.entity_count});
+            break;
+        case SceneRendererCmdType::UpdateEntityTransforms:
+            scene_renderer->UpdateEntityTransforms(scene_command.transforms_command.transform_buffer_index);
             break;
         case SceneRendererCmdType::AppendSurface:
             scene_renderer->AppendSurfaceToEntity(scene_command.surface_command.surface_id,
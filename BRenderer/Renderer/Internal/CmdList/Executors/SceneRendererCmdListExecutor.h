@@ -11,8 +11,8 @@ namespace brr::render::internal
     {
     public:
 
-        SceneRendererCmdListExecutor(const std::unordered_map<uint64_t, CmdList<SceneRendererCommand>>& scene_cmd_lists_map)
-        : m_scene_cmd_list_map(scene_cmd_lists_map)
+        SceneRendererCmdListExecutor(const CmdList<std::pair<uint64_t, SceneRendererCmdList>>& scene_cmd_lists)
+        : m_scene_cmd_lists(scene_cmd_lists)
         {}
 
         void ExecuteCmdList();
@@ -20,7 +20,7 @@ namespace brr::render::internal
     private:
         void ExecuteSceneRendererUpdateCommand(const SceneRendererCommand& scene_command, SceneRenderer* scene_renderer);
 
-        const std::unordered_map<uint64_t, CmdList<SceneRendererCommand>>& m_scene_cmd_list_map;
+        const CmdList<std::pair<uint64_t, SceneRendererCmdList>>& m_scene_cmd_lists;
     };
 }
 
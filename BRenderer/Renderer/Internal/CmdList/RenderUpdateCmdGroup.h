@@ -4,17 +4,68 @@
 #include "WindowCmdList.h"
 #include "SceneRendererCmdList.h"
 #include "ResourceCmdList.h"
+#include <Renderer/Allocators/FrameArena.h>
 #include <Renderer/GUI/ImDrawDataSnapshot.h>
 
+#include <memory>
+
 namespace brr::render::internal
 {
+    using SceneCmdListEntry = std::pair<uint64_t, SceneRendererCmdList>;
+
     struct RenderUpdateCmdGroup
     {
+        RenderUpdateCmdGroup()
+        : cmd_arena(std::make_unique<FrameArena>()),
+          window_cmd_list(cmd_arena.get()),
+          resource_cmd_list(cmd_arena.get()),
+          scene_cmd_lists(cmd_arena.get())
+        {}
+
+        RenderUpdateCmdGroup(RenderUpdateCmdGroup&&) noexcept = default;
+
+        RenderUpdateCmdGroup& operator=(RenderUpdateCmdGroup&& other) noexcept
+        {
+            // Lists are moved before the arena, since their current memory belongs to the current arena.
+            window_cmd_list          = std::move(other.window_cmd_list);
+            resource_cmd_list        = std::move(other.resource_cmd_list);
+            scene_cmd_lists          = std::move(other.scene_cmd_lists);
+            cmd_arena                = std::move(other.cmd_arena);
+            imgui_draw_data_snapshot = std::move(other.imgui_draw_data_snapshot);
+            return *this;
+        }
+
+        // Get the command list of the scene 'scene_id', creating it if this group has no commands for the scene yet.
+        SceneRendererCmdList& GetSceneCmdList(uint64_t scene_id)
+        {
+            for (SceneCmdListEntry& scene_cmd_list : scene_cmd_lists)
+            {
+                if (scene_cmd_list.first == scene_id)
+                {
+                    return scene_cmd_list.second;
+                }
+            }
+            return scene_cmd_lists.emplace_back(scene_id, SceneRendererCmdList(cmd_arena.get())).second;
+        }
+
+        // Clear all command lists and release the memory of the commands and their payloads.
+        void ResetCommands()
+        {
+            window_cmd_list   = WindowCmdList(cmd_arena.get());
+            resource_cmd_list = ResourceCmdList(cmd_arena.get());
+            scene_cmd_lists   = CmdList<SceneCmdListEntry>(cmd_arena.get());
+            cmd_arena->Reset();
+        }
+
+        // Owns the memory of every command list and command payload in this group.
+        // Kept in a unique_ptr so the lists' allocators stay valid when the group is moved.
+        std::unique_ptr<FrameArena> cmd_arena;
         WindowCmdList window_cmd_list;
         ResourceCmdList resource_cmd_list;
-        std::unordered_map<uint64_t, SceneRendererCmdList> scene_cmd_list_map;
+        // Scene command lists, in the order the scenes received commands. There are usually very few scenes.
+        CmdList<SceneCmdListEntry> scene_cmd_lists;
         ImDrawDataSnapshot imgui_draw_data_snapshot;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
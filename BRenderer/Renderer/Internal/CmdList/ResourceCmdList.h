@@ -4,6 +4,7 @@
 #include <Renderer/RenderEnums.h>
 #include <Renderer/RenderingResourceIDs.h>
 #include <Renderer/Storages/MaterialStorage.h>
+#include <Renderer/Allocators/FrameArena.h>
 
 namespace brr::render::internal
 {
@@ -20,7 +21,9 @@ namespace brr::render::internal
 
     struct ResourceCommand
     {
-        static ResourceCommand BuildCreateTexture2DCommand(TextureID texture_id,
+        // Payload data is copied to 'cmd_arena', so it is valid until the command group is reset.
+        static ResourceCommand BuildCreateTexture2DCommand(FrameArena& cmd_arena,
+                                                           TextureID texture_id,
                                                            const void* data,
                                                            uint32_t width,
                                                            uint32_t height,
@@ -36,7 +39,8 @@ namespace brr::render::internal
 
         static ResourceCommand BuildDestroyMaterialCommand(MaterialID material_id);
 
-        static ResourceCommand BuildCreateSurfaceCommand(SurfaceID surface_id,
+        static ResourceCommand BuildCreateSurfaceCommand(FrameArena& cmd_arena,
+                                                         SurfaceID surface_id,
                                                          const void* vertex_buffer,
                                                          size_t vertex_buffer_size,
                                                          const void* index_buffer,
@@ -149,20 +153,15 @@ namespace brr::render::internal
         }
     };
 
-    inline ResourceCommand ResourceCommand::BuildCreateTexture2DCommand(TextureID texture_id,
+    inline ResourceCommand ResourceCommand::BuildCreateTexture2DCommand(FrameArena& cmd_arena,
+                                                                        TextureID texture_id,
                                                                         const void* data,
                                                                         uint32_t width,
                                                                         uint32_t height,
                                                                         DataFormat image_format)
     {
         size_t format_size    = GetDataFormatByteSize(image_format);
-        void* image_data_copy = nullptr;
-        if (data)
-        {
-            size_t total_size = width * height * format_size;
-            image_data_copy   = malloc(total_size);
-            memcpy(image_data_copy, data, total_size);
-        }
+        void* image_data_copy = cmd_arena.Copy(data, width * height * format_size);
 
         ResourceCommand resource_command;
         resource_command.command_type    = ResourceCommandType::CreateTexture2D;
@@ -205,26 +204,16 @@ namespace brr::render::internal
         return resource_command;
     }
 
-    inline ResourceCommand ResourceCommand::BuildCreateSurfaceCommand(SurfaceID surface_id,
+    inline ResourceCommand ResourceCommand::BuildCreateSurfaceCommand(FrameArena& cmd_arena,
+                                                                      SurfaceID surface_id,
                                                                       const void* vertex_buffer,
                                                                       size_t vertex_buffer_size,
                                                                       const void* index_buffer,
                                                                       size_t index_buffer_size,
                                                                       MaterialID material_id)
     {
-        void* vertex_buffer_copy = nullptr;
-        if (vertex_buffer_size > 0)
-        {
-            vertex_buffer_copy = malloc(vertex_buffer_size);
-            memcpy(vertex_buffer_copy, vertex_buffer, vertex_buffer_size);
-        }
-
-        void* index_buffer_copy = nullptr;
-        if (index_buffer_size > 0)
-        {
-            index_buffer_copy = malloc(index_buffer_size);
-            memcpy(index_buffer_copy, index_buffer, index_buffer_size);
-        }
+        void* vertex_buffer_copy = cmd_arena.Copy(vertex_buffer, vertex_buffer_size);
+        void* index_buffer_copy  = cmd_arena.Copy(index_buffer, index_buffer_size);
 
         ResourceCommand resource_command;
         resource_command.command_type    = ResourceCommandType::CreateSurface;
@@ -5,9 +5,12 @@
 
 #include <Renderer/SceneObjectsIDs.h>
 #include <Renderer/RenderingResourceIDs.h>
+#include <Renderer/TransformChannel.h>
 
 #include <Core/thirdpartiesInc.h>
 
+#include <span>
+
 namespace brr::render::internal
 {
     enum class SceneRendererCmdType
@@ -18,7 +21,8 @@ namespace brr::render::internal
         // Entity
         CreateEntity,
         DestroyEntity,
-        UpdateEntityTransform,
+        DestroyEntities,
+        UpdateEntityTransforms,
         AppendSurface,
         // Camera
         CreateCamera,
@@ -35,10 +39,12 @@ namespace brr::render::internal
 
     struct SceneRendererCommand
     {
-        static SceneRendererCommand BuildCreateSceneRendererCommand()
+        // The SceneRenderer takes ownership of 'transform_channel' when the command is executed.
+        static SceneRendererCommand BuildCreateSceneRendererCommand(TransformChannel* transform_channel)
         {
             SceneRendererCommand scene_rend_command;
-            scene_rend_command.command_type = SceneRendererCmdType::CreateSceneRenderer;
+            scene_rend_command.command_type                    = SceneRendererCmdType::CreateSceneRenderer;
+            scene_rend_command.scene_command.transform_channel = transform_channel;
             return scene_rend_command;
         }
 
@@ -67,13 +73,29 @@ namespace brr::render::internal
             return scene_rend_command;
         }
 
-        static SceneRendererCommand BuildUpdateEntityTransformCommand(EntityID entity_id,
-                                                                      const glm::mat4& entity_transform)
+        // The IDs are copied to 'cmd_arena', so they are valid until the command group is reset.
+        // 'camera_ids' and 'light_ids' are destroyed before the entities.
+        static SceneRendererCommand BuildDestroyEntitiesCommand(FrameArena& cmd_arena,
+                                                                std::span<const EntityID> entity_ids,
+                                                                std::span<const CameraID> camera_ids = {},
+                                                                std::span<const LightID> light_ids = {})
         {
             SceneRendererCommand scene_rend_command;
-            scene_rend_command.command_type                    = SceneRendererCmdType::UpdateEntityTransform;
-            scene_rend_command.entity_command.entity_id        = entity_id;
-            scene_rend_command.entity_command.entity_transform = entity_transform;
+            scene_rend_command.command_type                  = SceneRendererCmdType::DestroyEntities;
+            scene_rend_command.entities_command.entity_ids   = static_cast<const EntityID*>(cmd_arena.Copy(entity_ids.data(), entity_ids.size_bytes()));
+            scene_rend_command.entities_command.entity_count = static_cast<uint32_t>(entity_ids.size());
+            scene_rend_command.entities_command.camera_ids   = static_cast<const CameraID*>(cmd_arena.Copy(camera_ids.data(), camera_ids.size_bytes()));
+            scene_rend_command.entities_command.camera_count = static_cast<uint32_t>(camera_ids.size());
+            scene_rend_command.entities_command.light_ids    = static_cast<const LightID*>(cmd_arena.Copy(light_ids.data(), light_ids.size_bytes()));
+            scene_rend_command.entities_command.light_count  = static_cast<uint32_t>(light_ids.size());
+            return scene_rend_command;
+        }
+
+        static SceneRendererCommand BuildUpdateEntityTransformsCommand(uint32_t transform_buffer_index)
+        {
+            SceneRendererCommand scene_rend_command;
+            scene_rend_command.command_type                              = SceneRendererCmdType::UpdateEntityTransforms;
+            scene_rend_command.transforms_command.transform_buffer_index = transform_buffer_index;
             return scene_rend_command;
         }
 
@@ -211,12 +233,32 @@ namespace brr::render::internal
 
         union
         {
+            struct
+            {
+                TransformChannel* transform_channel{nullptr};
+            } scene_command;
+
+            struct
+            {
+                uint32_t transform_buffer_index{0};
+            } transforms_command;
+
             struct
             {
                 EntityID entity_id{EntityID::NULL_ID};
                 glm::mat4 entity_transform{};
             } entity_command;
 
+            struct
+            {
+                const EntityID* entity_ids{nullptr};
+                const CameraID* camera_ids{nullptr};
+                const LightID* light_ids{nullptr};
+                uint32_t entity_count{0};
+                uint32_t camera_count{0};
+                uint32_t light_count{0};
+            } entities_command;
+
             struct
             {
                 EntityID owner_entity_id{EntityID::NULL_ID};
@@ -253,13 +295,20 @@ namespace brr::render::internal
             switch (other.command_type)
             {
             case SceneRendererCmdType::CreateSceneRenderer:
+                this->scene_command = other.scene_command;
+                break;
             case SceneRendererCmdType::DestroySceneRenderer:
                 break;
+            case SceneRendererCmdType::UpdateEntityTransforms:
+                this->transforms_command = other.transforms_command;
+                break;
             case SceneRendererCmdType::CreateEntity:
             case SceneRendererCmdType::DestroyEntity:
-            case SceneRendererCmdType::UpdateEntityTransform:
                 this->entity_command = other.entity_command;
                 break;
+            case SceneRendererCmdType::DestroyEntities:
+                this->entities_command = other.entities_command;
+                break;
             case SceneRendererCmdType::AppendSurface:
                 this->surface_command = other.surface_command;
                 break;
@@ -0,0 +1,529 @@
+#include "EntityBVH.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace brr::render::internal
+{
+    namespace
+    {
+        AABBB Union(const AABBB& first, const AABBB& second)
+        {
+            AABBB result = first;
+            result.Expand(second);
+            return result;
+        }
+
+        bool operator==(const AABBB& first, const AABBB& second)
+        {
+            return first.GetMinPos() == second.GetMinPos() && first.GetMaxPos() == second.GetMaxPos();
+        }
+    }
+
+    bool EntityBVH::Insert(EntityID entity_id, const AABBB& bounds)
+    {
+        assert(entity_id != EntityID::NULL_ID && "Can't insert the NULL_ID entity in EntityBVH.");
+        if (FindLocation(entity_id))
+        {
+            return false;
+        }
+
+        EntityLocation& location = GetOrCreateLocation(entity_id);
+        if (!bounds.IsValid())
+        {
+            AddUnbounded(entity_id, location);
+            return true;
+        }
+
+        const uint32_t leaf_index = AllocateNode();
+        m_nodes[leaf_index].bounds    = bounds;
+        m_nodes[leaf_index].entity_id = entity_id;
+        location.leaf_node = leaf_index;
+        m_leaves_count++;
+
+        InsertLeaf(leaf_index);
+        return true;
+    }
+
+    void EntityBVH::InsertBatch(std::span<const EntityID> entity_ids, std::span<const AABBB> bounds)
+    {
+        assert(entity_ids.size() == bounds.size() && "Each inserted entity must have bounds.");
+
+        // Adding a large batch one by one would degrade the tree anyway, so the leaves are added and the tree rebuilt.
+        const bool rebuild = entity_ids.size() > 1 && entity_ids.size() >= m_leaves_count / BATCH_REBUILD_DIVISOR;
+        if (!rebuild)
+        {
+            for (size_t index = 0; index < entity_ids.size(); index++)
+            {
+                Insert(entity_ids[index], bounds[index]);
+            }
+            return;
+        }
+
+        for (size_t index = 0; index < entity_ids.size(); index++)
+        {
+            const EntityID entity_id = entity_ids[index];
+            assert(entity_id != EntityID::NULL_ID && "Can't insert the NULL_ID entity in EntityBVH.");
+            if (FindLocation(entity_id))
+            {
+                continue;
+            }
+
+            EntityLocation& location = GetOrCreateLocation(entity_id);
+            if (!bounds[index].IsValid())
+            {
+                AddUnbounded(entity_id, location);
+                continue;
+            }
+
+            // Leaves are detached until the rebuild.
+            const uint32_t leaf_index = AllocateNode();
+            m_nodes[leaf_index].bounds    = bounds[index];
+            m_nodes[leaf_index].entity_id = entity_id;
+            location.leaf_node = leaf_index;
+            m_leaves_count++;
+        }
+        Rebuild();
+    }
+
+    bool EntityBVH::Remove(EntityID entity_id)
+    {
+        EntityLocation* location = FindLocation(entity_id);
+        if (!location)
+        {
+            return false;
+        }
+
+        if (location->unbounded_position != INVALID_NODE)
+        {
+            RemoveUnbounded(*location);
+            return true;
+        }
+
+        const uint32_t leaf_index = location->leaf_node;
+        RemoveLeaf(leaf_index);
+        FreeNode(leaf_index);
+        location->leaf_node = INVALID_NODE;
+        m_leaves_count--;
+        return true;
+    }
+
+    void EntityBVH::RemoveBatch(std::span<const EntityID> entity_ids)
+    {
+        for (EntityID entity_id : entity_ids)
+        {
+            Remove(entity_id);
+        }
+    }
+
+    void EntityBVH::Update(EntityID entity_id, const AABBB& bounds)
+    {
+        EntityLocation* location = FindLocation(entity_id);
+        if (!location)
+        {
+            assert(false && "Updating the bounds of an entity that is not in EntityBVH.");
+            return;
+        }
+
+        const bool was_unbounded = location->unbounded_position != INVALID_NODE;
+        if (was_unbounded || !bounds.IsValid())
+        {
+            if (was_unbounded && !bounds.IsValid())
+            {
+                return;
+            }
+            // Entity moves between the tree and the unbounded entities.
+            Remove(entity_id);
+            Insert(entity_id, bounds);
+            return;
+        }
+
+        const uint32_t leaf_index = location->leaf_node;
+        if (m_nodes[leaf_index].bounds == bounds)
+        {
+            return;
+        }
+        m_nodes[leaf_index].bounds = bounds;
+        RefitAncestors(m_nodes[leaf_index].parent);
+    }
+
+    bool EntityBVH::Contains(EntityID entity_id) const
+    {
+        return FindLocation(entity_id) != nullptr;
+    }
+
+    bool EntityBVH::RebuildIfDegraded()
+    {
+        if (m_leaves_count < 2 || GetCost() <= m_cost_after_rebuild * REBUILD_COST_RATIO)
+        {
+            return false;
+        }
+        Rebuild();
+        return true;
+    }
+
+    void EntityBVH::Rebuild()
+    {
+        std::vector<BuildLeaf> leaves;
+        leaves.reserve(m_leaves_count);
+        for (const Node& node : m_nodes)
+        {
+            // Free nodes have no entity.
+            if (node.IsLeaf() && node.entity_id != EntityID::NULL_ID)
+            {
+                const glm::vec3 centroid = (node.bounds.GetMinPos() + node.bounds.GetMaxPos()) * 0.5f;
+                leaves.push_back({node.bounds, centroid, node.entity_id});
+            }
+        }
+        assert(leaves.size() == m_leaves_count && "EntityBVH leaves count doesn't match its leaf nodes.");
+
+        m_nodes.clear();
+        m_free_nodes.clear();
+        m_internal_area_sum = 0.0;
+        m_root = INVALID_NODE;
+
+        if (!leaves.empty())
+        {
+            m_nodes.reserve(leaves.size() * 2 - 1);
+            m_root = BuildSubtree(leaves);
+        }
+        m_cost_after_rebuild = GetCost();
+    }
+
+    void EntityBVH::Clear()
+    {
+        m_nodes.clear();
+        m_free_nodes.clear();
+        m_root = INVALID_NODE;
+        m_leaves_count = 0;
+        m_internal_area_sum = 0.0;
+        m_cost_after_rebuild = 0.0f;
+        m_entity_locations.clear();
+        m_unbounded_entities.clear();
+    }
+
+    float EntityBVH::GetCost() const
+    {
+        if (m_root == INVALID_NODE)
+        {
+            return 0.0f;
+        }
+        const float root_area = Area(m_nodes[m_root].bounds);
+        return root_area > 0.0f ? static_cast<float>(m_internal_area_sum / root_area) : 0.0f;
+    }
+
+    float EntityBVH::Area(const AABBB& bounds)
+    {
+        if (!bounds.IsValid())
+        {
+            return 0.0f;
+        }
+        const glm::vec3 size = bounds.GetMaxPos() - bounds.GetMinPos();
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    EntityBVH::EntityLocation* EntityBVH::FindLocation(EntityID entity_id)
+    {
+        return const_cast<EntityLocation*>(std::as_const(*this).FindLocation(entity_id));
+    }
+
+    const EntityBVH::EntityLocation* EntityBVH::FindLocation(EntityID entity_id) const
+    {
+        const uint32_t id_index = GetRenderIdIndex(entity_id);
+        if (entity_id == EntityID::NULL_ID || id_index >= m_entity_locations.size())
+        {
+            return nullptr;
+        }
+
+        // Locations are indexed without the generation, so the stored entity must match the full ID.
+        const EntityLocation& location = m_entity_locations[id_index];
+        if (location.leaf_node != INVALID_NODE && m_nodes[location.leaf_node].entity_id == entity_id)
+        {
+            return &location;
+        }
+        if (location.unbounded_position != INVALID_NODE && m_unbounded_entities[location.unbounded_position] == entity_id)
+        {
+            return &location;
+        }
+        return nullptr;
+    }
+
+    EntityBVH::EntityLocation& EntityBVH::GetOrCreateLocation(EntityID entity_id)
+    {
+        const uint32_t id_index = GetRenderIdIndex(entity_id);
+        if (id_index >= m_entity_locations.size())
+        {
+            m_entity_locations.resize(std::max<size_t>(id_index + 1, m_entity_locations.size() * 2));
+        }
+        return m_entity_locations[id_index];
+    }
+
+    uint32_t EntityBVH::AllocateNode()
+    {
+        if (!m_free_nodes.empty())
+        {
+            const uint32_t node_index = m_free_nodes.back();
+            m_free_nodes.pop_back();
+            return node_index;
+        }
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    void EntityBVH::FreeNode(uint32_t node_index)
+    {
+        if (!m_nodes[node_index].IsLeaf())
+        {
+            m_internal_area_sum -= Area(m_nodes[node_index].bounds);
+        }
+        m_nodes[node_index] = Node{};
+        m_free_nodes.push_back(node_index);
+    }
+
+    void EntityBVH::SetNodeBounds(uint32_t node_index, const AABBB& bounds)
+    {
+        Node& node = m_nodes[node_index];
+        if (!node.IsLeaf())
+        {
+            m_internal_area_sum += static_cast<double>(Area(bounds)) - Area(node.bounds);
+        }
+        node.bounds = bounds;
+    }
+
+    void EntityBVH::InsertLeaf(uint32_t leaf_index)
+    {
+        if (m_root == INVALID_NODE)
+        {
+            m_root = leaf_index;
+            m_nodes[leaf_index].parent = INVALID_NODE;
+            return;
+        }
+
+        // Walk down choosing the child that least increases the area of the tree, and stop when pairing the leaf
+        // with the current node is cheaper than descending.
+        const AABBB leaf_bounds = m_nodes[leaf_index].bounds;
+        uint32_t sibling = m_root;
+        while (!m_nodes[sibling].IsLeaf())
+        {
+            const Node& node = m_nodes[sibling];
+            const float area          = Area(node.bounds);
+            const float combined_area = Area(Union(node.bounds, leaf_bounds));
+
+            // Cost of a new parent for this node and the leaf, and cost added to this node by descending.
+            const float pair_cost        = 2.0f * combined_area;
+            const float inheritance_cost = 2.0f * (combined_area - area);
+
+            std::array<float, 2> child_costs;
+            for (uint32_t child = 0; child < 2; child++)
+            {
+                const Node& child_node = m_nodes[node.children[child]];
+                const float child_combined_area = Area(Union(child_node.bounds, leaf_bounds));
+                child_costs[child] = inheritance_cost
+                                   + (child_node.IsLeaf() ? child_combined_area : child_combined_area - Area(child_node.bounds));
+            }
+
+            if (pair_cost < child_costs[0] && pair_cost < child_costs[1])
+            {
+                break;
+            }
+            sibling = child_costs[0] <= child_costs[1] ? node.children[0] : node.children[1];
+        }
+
+        const uint32_t old_parent = m_nodes[sibling].parent;
+        const uint32_t new_parent = AllocateNode();
+        m_nodes[new_parent].parent      = old_parent;
+        m_nodes[new_parent].children[0] = sibling;
+        m_nodes[new_parent].children[1] = leaf_index;
+        SetNodeBounds(new_parent, Union(m_nodes[sibling].bounds, leaf_bounds));
+        m_nodes[sibling].parent    = new_parent;
+        m_nodes[leaf_index].parent = new_parent;
+
+        if (old_parent == INVALID_NODE)
+        {
+            m_root = new_parent;
+            return;
+        }
+
+        Node& old_parent_node = m_nodes[old_parent];
+        old_parent_node.children[old_parent_node.children[0] == sibling ? 0 : 1] = new_parent;
+        RefitAncestors(old_parent);
+    }
+
+    void EntityBVH::RemoveLeaf(uint32_t leaf_index)
+    {
+        if (leaf_index == m_root)
+        {
+            m_root = INVALID_NODE;
+            return;
+        }
+
+        const uint32_t parent      = m_nodes[leaf_index].parent;
+        const uint32_t grandparent = m_nodes[parent].parent;
+        const uint32_t sibling     = m_nodes[parent].children[m_nodes[parent].children[0] == leaf_index ? 1 : 0];
+
+        // The sibling takes the place of the parent.
+        m_nodes[sibling].parent = grandparent;
+        FreeNode(parent);
+        m_nodes[leaf_index].parent = INVALID_NODE;
+
+        if (grandparent == INVALID_NODE)
+        {
+            m_root = sibling;
+            return;
+        }
+
+        Node& grandparent_node = m_nodes[grandparent];
+        grandparent_node.children[grandparent_node.children[0] == parent ? 0 : 1] = sibling;
+        RefitAncestors(grandparent);
+    }
+
+    void EntityBVH::RefitAncestors(uint32_t node_index)
+    {
+        while (node_index != INVALID_NODE)
+        {
+            const Node& node = m_nodes[node_index];
+            const AABBB bounds = Union(m_nodes[node.children[0]].bounds, m_nodes[node.children[1]].bounds);
+            if (bounds == node.bounds)
+            {
+                // Ancestors contain the same bounds, so they don't change either.
+                return;
+            }
+            SetNodeBounds(node_index, bounds);
+            node_index = m_nodes[node_index].parent;
+        }
+    }
+
+    void EntityBVH::AddUnbounded(EntityID entity_id, EntityLocation& location)
+    {
+        location.unbounded_position = static_cast<uint32_t>(m_unbounded_entities.size());
+        m_unbounded_entities.push_back(entity_id);
+    }
+
+    void EntityBVH::RemoveUnbounded(EntityLocation& location)
+    {
+        const uint32_t position = location.unbounded_position;
+        const EntityID last_entity = m_unbounded_entities.back();
+        m_unbounded_entities[position] = last_entity;
+        m_entity_locations[GetRenderIdIndex(last_entity)].unbounded_position = position;
+        m_unbounded_entities.pop_back();
+        location.unbounded_position = INVALID_NODE;
+    }
+
+    uint32_t EntityBVH::BuildSubtree(std::span<BuildLeaf> leaves)
+    {
+        if (leaves.size() == 1)
+        {
+            const uint32_t leaf_index = AllocateNode();
+            m_nodes[leaf_index].bounds    = leaves[0].bounds;
+            m_nodes[leaf_index].entity_id = leaves[0].entity_id;
+            m_entity_locations[GetRenderIdIndex(leaves[0].entity_id)].leaf_node = leaf_index;
+            return leaf_index;
+        }
+
+        AABBB centroid_bounds;
+        for (const BuildLeaf& leaf : leaves)
+        {
+            centroid_bounds.Expand(AABBB(leaf.centroid, leaf.centroid));
+        }
+        const glm::vec3 centroid_extent = centroid_bounds.GetMaxPos() - centroid_bounds.GetMinPos();
+
+        // Binned SAH: leaves are grouped in bins by centroid along each axis, and the split between bins with the
+        // lowest 'count * area' on both sides is chosen.
+        struct Bin
+        {
+            AABBB bounds;
+            uint32_t count = 0;
+        };
+
+        float best_cost = std::numeric_limits<float>::max();
+        int best_axis   = -1;
+        uint32_t best_split = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (centroid_extent[axis] <= 0.0f)
+            {
+                continue;
+            }
+
+            const float bin_scale = SAH_BINS_COUNT / centroid_extent[axis];
+            const auto get_bin = [&](const BuildLeaf& leaf)
+            {
+                const float bin = (leaf.centroid[axis] - centroid_bounds.GetMinPos()[axis]) * bin_scale;
+                return std::min(static_cast<uint32_t>(bin), SAH_BINS_COUNT - 1);
+            };
+
+            std::array<Bin, SAH_BINS_COUNT> bins {};
+            for (const BuildLeaf& leaf : leaves)
+            {
+                Bin& bin = bins[get_bin(leaf)];
+                bin.bounds.Expand(leaf.bounds);
+                bin.count++;
+            }
+
+            // Area and count to the right of each split, swept from the last bin.
+            std::array<float, SAH_BINS_COUNT> right_areas {};
+            std::array<uint32_t, SAH_BINS_COUNT> right_counts {};
+            AABBB right_bounds;
+            uint32_t right_count = 0;
+            for (uint32_t bin = SAH_BINS_COUNT - 1; bin > 0; bin--)
+            {
+                right_bounds.Expand(bins[bin].bounds);
+                right_count += bins[bin].count;
+                right_areas[bin]  = Area(right_bounds);
+                right_counts[bin] = right_count;
+            }
+
+            AABBB left_bounds;
+            uint32_t left_count = 0;
+            for (uint32_t split = 0; split < SAH_BINS_COUNT - 1; split++)
+            {
+                left_bounds.Expand(bins[split].bounds);
+                left_count += bins[split].count;
+                if (left_count == 0 || right_counts[split + 1] == 0)
+                {
+                    continue;
+                }
+
+                const float cost = left_count * Area(left_bounds) + right_counts[split + 1] * right_areas[split + 1];
+                if (cost < best_cost)
+                {
+                    best_cost  = cost;
+                    best_axis  = axis;
+                    best_split = split;
+                }
+            }
+        }
+
+        size_t middle;
+        if (best_axis >= 0)
+        {
+            const float bin_scale = SAH_BINS_COUNT / centroid_extent[best_axis];
+            const float axis_min  = centroid_bounds.GetMinPos()[best_axis];
+            const auto split_it = std::partition(leaves.begin(), leaves.end(), [&](const BuildLeaf& leaf)
+            {
+                const float bin = (leaf.centroid[best_axis] - axis_min) * bin_scale;
+                return std::min(static_cast<uint32_t>(bin), SAH_BINS_COUNT - 1) <= best_split;
+            });
+            middle = static_cast<size_t>(split_it - leaves.begin());
+        }
+        else
+        {
+            // All centroids are in the same place. Any split is as good as the others.
+            middle = leaves.size() / 2;
+        }
+
+        const uint32_t node_index = AllocateNode();
+        const uint32_t left  = BuildSubtree(leaves.first(middle));
+        const uint32_t right = BuildSubtree(leaves.subspan(middle));
+
+        m_nodes[node_index].children[0] = left;
+        m_nodes[node_index].children[1] = right;
+        m_nodes[left].parent  = node_index;
+        m_nodes[right].parent = node_index;
+        SetNodeBounds(node_index, Union(m_nodes[left].bounds, m_nodes[right].bounds));
+        return node_index;
+    }
+}
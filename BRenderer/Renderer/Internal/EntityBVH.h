@@ -0,0 +1,351 @@
+#ifndef BRR_ENTITYBVH_H
+#define BRR_ENTITYBVH_H
+
+#include <Geometry/Frustum.h>
+#include <Geometry/Geometry.h>
+#include <Renderer/SceneObjectsIDs.h>
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace brr::render::internal
+{
+    /**
+     * \brief Dynamic bounding volume hierarchy over the world bounds of the entities of a SceneRenderer.
+     *
+     * Each entity is a leaf. Inserting a single entity walks down the tree choosing the sibling that least increases
+     * the surface area of the tree, and updating the bounds of an entity only refits its ancestors. Refits and
+     * insertions degrade the tree over time, so `RebuildIfDegraded` rebuilds it with a binned SAH build when its cost
+     * grows too much compared to the last build.
+     *
+     * Entities with invalid bounds are not part of the tree. They are always reported by frustum queries, and never
+     * by box and ray queries.
+     */
+    class EntityBVH
+    {
+    public:
+        /**
+         * \brief Insert an entity. Returns false if the entity is already in the tree.
+         */
+        bool Insert(EntityID entity_id, const AABBB& bounds);
+
+        /**
+         * \brief Insert many entities at once. Rebuilds the whole tree when the batch is large compared to the tree.
+         */
+        void InsertBatch(std::span<const EntityID> entity_ids, std::span<const AABBB> bounds);
+
+        /**
+         * \brief Remove an entity. Returns false if the entity is not in the tree.
+         */
+        bool Remove(EntityID entity_id);
+
+        void RemoveBatch(std::span<const EntityID> entity_ids);
+
+        /**
+         * \brief Update the bounds of an entity, refitting the bounds of its ancestors.
+         */
+        void Update(EntityID entity_id, const AABBB& bounds);
+
+        [[nodiscard]] bool Contains(EntityID entity_id) const;
+
+        /**
+         * \brief Rebuild the tree with SAH if its cost grew more than 'REBUILD_COST_RATIO' times its cost after the
+         *        last build.
+         * \return true if the tree was rebuilt.
+         */
+        bool RebuildIfDegraded();
+
+        void Rebuild();
+
+        void Clear();
+
+        [[nodiscard]] uint32_t Size() const { return m_leaves_count + static_cast<uint32_t>(m_unbounded_entities.size()); }
+
+        /**
+         * \brief SAH cost of the tree: sum of the surface areas of the internal nodes, relative to the root's.
+         */
+        [[nodiscard]] float GetCost() const;
+
+        /**
+         * \brief Call 'func(entity_id)' for each entity that may be visible in the frustum. Subtrees outside the
+         *        frustum are skipped, and subtrees inside it are reported without further tests. Leaves of subtrees
+         *        that intersect the frustum are tested in batches with 'CullAABBs'.
+         */
+        template <typename Func>
+        void QueryFrustum(const Frustum& frustum, Func&& func) const;
+
+        /**
+         * \brief Call 'func(entity_id)' for each entity whose bounds overlap 'box'.
+         */
+        template <typename Func>
+        void QueryBox(const AABBB& box, Func&& func) const;
+
+        /**
+         * \brief Call 'func(entity_id, distance)' for each entity whose bounds are hit by the ray before 'max_distance',
+         *        where 'distance' is where the ray enters the bounds, in units of 'direction'.
+         */
+        template <typename Func>
+        void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, Func&& func) const;
+
+    private:
+        static constexpr uint32_t INVALID_NODE       = static_cast<uint32_t>(-1);
+        static constexpr float REBUILD_COST_RATIO    = 1.5f;
+        static constexpr uint32_t SAH_BINS_COUNT     = 16;
+        // Fraction of the tree that a batch must have to rebuild the tree instead of inserting one by one.
+        static constexpr uint32_t BATCH_REBUILD_DIVISOR = 4;
+        // Number of leaves tested together by 'QueryFrustum'.
+        static constexpr uint32_t FRUSTUM_LEAF_BATCH_SIZE = 64;
+
+        struct Node
+        {
+            [[nodiscard]] bool IsLeaf() const { return children[0] == INVALID_NODE; }
+
+            AABBB bounds;
+            uint32_t parent      = INVALID_NODE;
+            uint32_t children[2] = {INVALID_NODE, INVALID_NODE};
+            EntityID entity_id   = EntityID::NULL_ID;
+        };
+
+        // Where the entity with an EntityID index is stored. Only one of the fields is valid.
+        struct EntityLocation
+        {
+            uint32_t leaf_node          = INVALID_NODE;
+            uint32_t unbounded_position = INVALID_NODE;
+        };
+
+        /**
+         * \brief Traversal stack of the queries. Entries live in a fixed-size array, so queries don't allocate unless
+         *        the tree is deeper than 'INLINE_CAPACITY', which only happens when insertions degraded it badly.
+         */
+        template <typename Entry>
+        class QueryStack
+        {
+        public:
+            [[nodiscard]] bool Empty() const { return m_size == 0; }
+
+            void Push(const Entry& entry)
+            {
+                if (m_size < INLINE_CAPACITY)
+                {
+                    m_inline_entries[m_size] = entry;
+                }
+                else
+                {
+                    m_overflow_entries.push_back(entry);
+                }
+                m_size++;
+            }
+
+            Entry Pop()
+            {
+                m_size--;
+                if (m_size < INLINE_CAPACITY)
+                {
+                    return m_inline_entries[m_size];
+                }
+                Entry entry = m_overflow_entries.back();
+                m_overflow_entries.pop_back();
+                return entry;
+            }
+
+        private:
+            static constexpr uint32_t INLINE_CAPACITY = 64;
+
+            std::array<Entry, INLINE_CAPACITY> m_inline_entries;
+            std::vector<Entry> m_overflow_entries;
+            uint32_t m_size = 0;
+        };
+
+        struct BuildLeaf
+        {
+            AABBB bounds;
+            glm::vec3 centroid;
+            EntityID entity_id;
+        };
+
+        static float Area(const AABBB& bounds);
+
+        EntityLocation* FindLocation(EntityID entity_id);
+        [[nodiscard]] const EntityLocation* FindLocation(EntityID entity_id) const;
+        EntityLocation& GetOrCreateLocation(EntityID entity_id);
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t node_index);
+
+        void SetNodeBounds(uint32_t node_index, const AABBB& bounds);
+
+        void InsertLeaf(uint32_t leaf_index);
+        void RemoveLeaf(uint32_t leaf_index);
+        void RefitAncestors(uint32_t node_index);
+
+        void AddUnbounded(EntityID entity_id, EntityLocation& location);
+        void RemoveUnbounded(EntityLocation& location);
+
+        uint32_t BuildSubtree(std::span<BuildLeaf> leaves);
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_free_nodes;
+        uint32_t m_root = INVALID_NODE;
+        uint32_t m_leaves_count = 0;
+
+        // Sum of the surface areas of the internal nodes, kept up to date when their bounds change.
+        double m_internal_area_sum = 0.0;
+        float m_cost_after_rebuild = 0.0f;
+
+        // Indexed by the index of the EntityIDs.
+        std::vector<EntityLocation> m_entity_locations;
+        std::vector<EntityID> m_unbounded_entities;
+    };
+
+    /**********************
+     *** Implementation ***
+     *********************/
+
+    template <typename Func>
+    void EntityBVH::QueryFrustum(const Frustum& frustum, Func&& func) const
+    {
+        for (EntityID entity_id : m_unbounded_entities)
+        {
+            func(entity_id);
+        }
+        if (m_root == INVALID_NODE)
+        {
+            return;
+        }
+
+        struct StackEntry
+        {
+            uint32_t node_index;
+            uint8_t planes_mask;
+            bool inside;
+        };
+        std::array<AABBB, FRUSTUM_LEAF_BATCH_SIZE> leaf_bounds;
+        std::array<EntityID, FRUSTUM_LEAF_BATCH_SIZE> leaf_entities;
+        std::array<uint8_t, FRUSTUM_LEAF_BATCH_SIZE> leaf_visible;
+        uint32_t leaf_count = 0;
+        const auto cull_leaves = [&]()
+        {
+            CullAABBs(frustum, {leaf_bounds.data(), leaf_count}, leaf_visible.data());
+            for (uint32_t leaf = 0; leaf < leaf_count; leaf++)
+            {
+                if (leaf_visible[leaf])
+                {
+                    func(leaf_entities[leaf]);
+                }
+            }
+            leaf_count = 0;
+        };
+
+        QueryStack<StackEntry> stack;
+        stack.Push({m_root, Frustum::ALL_PLANES_MASK, false});
+        while (!stack.Empty())
+        {
+            StackEntry entry = stack.Pop();
+
+            const Node& node = m_nodes[entry.node_index];
+            if (node.IsLeaf())
+            {
+                if (entry.inside)
+                {
+                    func(node.entity_id);
+                    continue;
+                }
+                leaf_bounds[leaf_count]   = node.bounds;
+                leaf_entities[leaf_count] = node.entity_id;
+                if (++leaf_count == FRUSTUM_LEAF_BATCH_SIZE)
+                {
+                    cull_leaves();
+                }
+                continue;
+            }
+
+            if (!entry.inside)
+            {
+                const Frustum::Containment containment = frustum.Classify(node.bounds, entry.planes_mask);
+                if (containment == Frustum::Containment::Outside)
+                {
+                    continue;
+                }
+                entry.inside = containment == Frustum::Containment::Inside;
+            }
+            stack.Push({node.children[0], entry.planes_mask, entry.inside});
+            stack.Push({node.children[1], entry.planes_mask, entry.inside});
+        }
+
+        if (leaf_count > 0)
+        {
+            cull_leaves();
+        }
+    }
+
+    template <typename Func>
+    void EntityBVH::QueryBox(const AABBB& box, Func&& func) const
+    {
+        if (m_root == INVALID_NODE || !box.IsValid())
+        {
+            return;
+        }
+
+        QueryStack<uint32_t> stack;
+        stack.Push(m_root);
+        while (!stack.Empty())
+        {
+            const Node& node = m_nodes[stack.Pop()];
+
+            if (glm::any(glm::lessThan(node.bounds.GetMaxPos(), box.GetMinPos()))
+                || glm::any(glm::greaterThan(node.bounds.GetMinPos(), box.GetMaxPos())))
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                func(node.entity_id);
+                continue;
+            }
+            stack.Push(node.children[0]);
+            stack.Push(node.children[1]);
+        }
+    }
+
+    template <typename Func>
+    void EntityBVH::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, Func&& func) const
+    {
+        if (m_root == INVALID_NODE)
+        {
+            return;
+        }
+
+        // Division by zero gives infinities, which the slab test handles.
+        const glm::vec3 inverse_direction = 1.0f / direction;
+
+        QueryStack<uint32_t> stack;
+        stack.Push(m_root);
+        while (!stack.Empty())
+        {
+            const Node& node = m_nodes[stack.Pop()];
+
+            const glm::vec3 slab_a = (node.bounds.GetMinPos() - origin) * inverse_direction;
+            const glm::vec3 slab_b = (node.bounds.GetMaxPos() - origin) * inverse_direction;
+            const glm::vec3 slab_near = glm::min(slab_a, slab_b);
+            const glm::vec3 slab_far  = glm::max(slab_a, slab_b);
+            const float enter_distance = std::max(std::max(slab_near.x, slab_near.y), std::max(slab_near.z, 0.0f));
+            const float exit_distance  = std::min(std::min(slab_far.x, slab_far.y), std::min(slab_far.z, max_distance));
+            if (enter_distance > exit_distance)
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                func(node.entity_id, enter_distance);
+                continue;
+            }
+            stack.Push(node.children[0]);
+            stack.Push(node.children[1]);
+        }
+    }
+}
+
+#endif
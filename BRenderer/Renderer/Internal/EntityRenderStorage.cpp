@@ -0,0 +1,152 @@
+#include "EntityRenderStorage.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace brr::render::internal
+{
+    // Surfaces array is only compacted after it has at least this many unused elements.
+    static constexpr size_t MIN_UNUSED_SURFACES_TO_COMPACT = 1024;
+    static constexpr uint32_t MIN_SURFACE_RANGE_CAPACITY   = 2;
+
+    uint32_t EntityRenderStorage::Add(EntityID entity_id, const glm::mat4& transform)
+    {
+        assert(entity_id != EntityID::NULL_ID && "Can't add the NULL_ID entity to EntityRenderStorage.");
+
+        const size_t id_index = GetRenderIdIndex(entity_id);
+        if (id_index >= m_id_to_slot.size())
+        {
+            m_id_to_slot.resize(std::max(id_index + 1, m_id_to_slot.size() * 2), INVALID_SLOT);
+        }
+        else if (m_id_to_slot[id_index] != INVALID_SLOT)
+        {
+            return INVALID_SLOT;
+        }
+
+        const uint32_t slot = Size();
+        m_id_to_slot[id_index] = slot;
+
+        ids.push_back(entity_id);
+        transforms.push_back(transform);
+        // Per-slot data uploaded to the GPU must be written for every frame buffer.
+        dirty_flags.push_back(TRANSFORM_DIRTY_MASK);
+        local_bounds.emplace_back();
+        bounds.emplace_back();
+        surface_ranges.emplace_back();
+        attached_lights.push_back(LightID::NULL_ID);
+
+        return slot;
+    }
+
+    void EntityRenderStorage::Remove(EntityID entity_id)
+    {
+        const uint32_t slot = GetSlot(entity_id);
+        if (slot == INVALID_SLOT)
+        {
+            return;
+        }
+
+        m_unused_surfaces_count += surface_ranges[slot].capacity;
+        m_surfaces_count        -= surface_ranges[slot].count;
+        m_id_to_slot[GetRenderIdIndex(entity_id)] = INVALID_SLOT;
+
+        const uint32_t last_slot = Size() - 1;
+        if (slot != last_slot)
+        {
+            ids[slot]             = ids[last_slot];
+            transforms[slot]      = transforms[last_slot];
+            dirty_flags[slot]     = dirty_flags[last_slot] | TRANSFORM_DIRTY_MASK;
+            local_bounds[slot]    = local_bounds[last_slot];
+            bounds[slot]          = bounds[last_slot];
+            surface_ranges[slot]  = surface_ranges[last_slot];
+            attached_lights[slot] = attached_lights[last_slot];
+
+            m_id_to_slot[GetRenderIdIndex(ids[slot])] = slot;
+        }
+
+        ids.pop_back();
+        transforms.pop_back();
+        dirty_flags.pop_back();
+        local_bounds.pop_back();
+        bounds.pop_back();
+        surface_ranges.pop_back();
+        attached_lights.pop_back();
+
+        if (ids.empty())
+        {
+            m_surfaces.clear();
+            m_unused_surfaces_count = 0;
+        }
+    }
+
+    bool EntityRenderStorage::AppendSurface(uint32_t slot, SurfaceID surface_id)
+    {
+        const std::span<const SurfaceID> surfaces = GetSurfaces(slot);
+        if (std::ranges::find(surfaces, surface_id) != surfaces.end())
+        {
+            return false;
+        }
+
+        SurfaceRange& range = surface_ranges[slot];
+        if (range.count == range.capacity)
+        {
+            // Range is full. Move it to the end of the surfaces array with more capacity.
+            const uint32_t new_capacity = std::max(range.capacity * 2, MIN_SURFACE_RANGE_CAPACITY);
+            const uint32_t new_offset   = static_cast<uint32_t>(m_surfaces.size());
+            m_surfaces.resize(m_surfaces.size() + new_capacity);
+            std::copy_n(m_surfaces.begin() + range.offset, range.count, m_surfaces.begin() + new_offset);
+
+            m_unused_surfaces_count += range.capacity;
+            range.offset   = new_offset;
+            range.capacity = new_capacity;
+        }
+
+        m_surfaces[range.offset + range.count] = surface_id;
+        range.count++;
+        m_surfaces_count++;
+
+        if (m_unused_surfaces_count >= MIN_UNUSED_SURFACES_TO_COMPACT && m_unused_surfaces_count > m_surfaces.size() / 2)
+        {
+            CompactSurfaces();
+        }
+        return true;
+    }
+
+    void EntityRenderStorage::RemoveSurface(uint32_t slot, SurfaceID surface_id)
+    {
+        SurfaceRange& range = surface_ranges[slot];
+        const auto range_begin = m_surfaces.begin() + range.offset;
+        const auto range_end   = range_begin + range.count;
+
+        const auto surface_it = std::find(range_begin, range_end, surface_id);
+        if (surface_it != range_end)
+        {
+            *surface_it = *(range_end - 1);
+            range.count--;
+            m_surfaces_count--;
+        }
+    }
+
+    void EntityRenderStorage::CompactSurfaces()
+    {
+        // Ranges are rebuilt in slot order, keeping their capacity, so entities can keep appending surfaces.
+        std::vector<SurfaceID> compacted_surfaces;
+        size_t total_capacity = 0;
+        for (const SurfaceRange& range : surface_ranges)
+        {
+            total_capacity += range.capacity;
+        }
+        compacted_surfaces.resize(total_capacity);
+
+        uint32_t offset = 0;
+        for (SurfaceRange& range : surface_ranges)
+        {
+            std::copy_n(m_surfaces.begin() + range.offset, range.count, compacted_surfaces.begin() + offset);
+            range.offset = offset;
+            offset      += range.capacity;
+        }
+
+        m_surfaces              = std::move(compacted_surfaces);
+        m_unused_surfaces_count = 0;
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef BRR_ENTITYRENDERSTORAGE_H
+#define BRR_ENTITYRENDERSTORAGE_H
+
+#include <Geometry/Geometry.h>
+#include <Renderer/RenderDefs.h>
+#include <Renderer/RenderingResourceIDs.h>
+#include <Renderer/SceneObjectsIDs.h>
+
+#include <span>
+#include <vector>
+
+namespace brr::render::internal
+{
+    /**
+     * \brief Render state of the entities of a SceneRenderer, stored as structure-of-arrays.
+     *
+     * Each entity occupies a dense slot, and each piece of its state lives in a separate array indexed by that slot,
+     * so per-frame updates and draw building are linear sweeps over the arrays they need.
+     * Removing an entity moves the last entity to its slot. Slots are therefore only valid until the next removal.
+     * New and moved entities have the transforms of all frame buffers marked dirty, so per-slot GPU data is rewritten.
+     *
+     * The surfaces of all entities are stored in a single array, where each entity owns a range. Ranges that get full
+     * are moved to the end of the array with twice the capacity, and the array is compacted when more than half of
+     * it is unused.
+     */
+    class EntityRenderStorage
+    {
+    public:
+        static constexpr uint32_t INVALID_SLOT = static_cast<uint32_t>(-1);
+
+        // One transform dirty bit per frame buffer, followed by the surfaces and world bounds dirty bits.
+        static constexpr uint8_t TRANSFORM_DIRTY_MASK = (1u << FRAME_LAG) - 1;
+        static constexpr uint8_t SURFACES_DIRTY_BIT   = 1u << FRAME_LAG;
+        static constexpr uint8_t BOUNDS_DIRTY_BIT     = 1u << (FRAME_LAG + 1);
+
+        struct SurfaceRange
+        {
+            uint32_t offset   = 0;
+            uint32_t count    = 0;
+            uint32_t capacity = 0;
+        };
+
+        /**
+         * \brief Add an entity at the end of the arrays.
+         * \return Slot of the new entity. INVALID_SLOT if the entity already exists.
+         */
+        uint32_t Add(EntityID entity_id, const glm::mat4& transform);
+
+        /**
+         * \brief Remove the entity, moving the last entity to its slot.
+         */
+        void Remove(EntityID entity_id);
+
+        [[nodiscard]] uint32_t GetSlot(EntityID entity_id) const
+        {
+            const uint32_t slot = GetSlotByIndex(GetRenderIdIndex(entity_id));
+            // Stale IDs with the index of a newer entity don't match its generation.
+            return slot != INVALID_SLOT && ids[slot] == entity_id ? slot : INVALID_SLOT;
+        }
+
+        /**
+         * \brief Get the slot of the entity alive with the EntityID index 'id_index', whatever its generation.
+         */
+        [[nodiscard]] uint32_t GetSlotByIndex(uint32_t id_index) const
+        {
+            return id_index < m_id_to_slot.size() ? m_id_to_slot[id_index] : INVALID_SLOT;
+        }
+
+        [[nodiscard]] bool Contains(EntityID entity_id) const { return GetSlot(entity_id) != INVALID_SLOT; }
+
+        [[nodiscard]] uint32_t Size() const { return static_cast<uint32_t>(ids.size()); }
+
+        /**
+         * \brief Number of surfaces of all entities.
+         */
+        [[nodiscard]] uint32_t SurfacesCount() const { return m_surfaces_count; }
+
+        [[nodiscard]] std::span<const SurfaceID> GetSurfaces(uint32_t slot) const
+        {
+            const SurfaceRange& range = surface_ranges[slot];
+            return {m_surfaces.data() + range.offset, range.count};
+        }
+
+        /**
+         * \brief Append a surface to the entity in 'slot'.
+         * \return false if the surface was already assigned to this entity.
+         */
+        bool AppendSurface(uint32_t slot, SurfaceID surface_id);
+
+        void RemoveSurface(uint32_t slot, SurfaceID surface_id);
+
+        // Dense arrays, indexed by slot.
+        std::vector<EntityID> ids;
+        std::vector<glm::mat4> transforms;
+        std::vector<uint8_t> dirty_flags;
+        // Union of the bounds of the entity surfaces, in local space.
+        std::vector<AABBB> local_bounds;
+        // Local bounds transformed to world space.
+        std::vector<AABBB> bounds;
+        std::vector<SurfaceRange> surface_ranges;
+        std::vector<LightID> attached_lights;
+
+    private:
+        void CompactSurfaces();
+
+        // Sparse array, indexed by the index of the EntityIDs. Indices are recycled, so it stays dense.
+        std::vector<uint32_t> m_id_to_slot;
+
+        std::vector<SurfaceID> m_surfaces;
+        size_t m_unused_surfaces_count = 0;
+        uint32_t m_surfaces_count = 0;
+    };
+}
+
+#endif
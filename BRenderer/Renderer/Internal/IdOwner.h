@@ -1,6 +1,13 @@
 #ifndef BRR_IDOWNER_H
 #define BRR_IDOWNER_H
 
+#include <Renderer/SceneObjectsIDs.h>
+
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <vector>
+
 namespace brr::render::internal
 {
     template <typename IdType>
@@ -15,6 +22,63 @@ namespace brr::render::internal
     private:
         std::atomic<IdType> m_current_id = 0;
     };
+
+    /**
+     * \brief Generates scene object IDs, recycling the indices of released IDs (see SceneObjectsIDs.h).
+     *
+     * Released indices are only reused after at least 'MIN_FREE_INDICES' other indices are released, and each reuse
+     * increments the index generation, so stale IDs kept by the render thread don't match the new object.
+     *
+     * Not thread-safe. Each owner must be used by a single thread. An ID can be released as soon as the command that
+     * destroys its object is pushed: commands are executed in order, so the render thread destroys the old object
+     * before creating the object that reuses the index.
+     */
+    template <typename IdType>
+        requires std::is_enum_v<IdType>
+    class RecycledIdOwner
+    {
+    public:
+        static constexpr size_t MIN_FREE_INDICES = 1024;
+
+        IdType GetNewId()
+        {
+            uint32_t index;
+            if (m_free_indices.size() > MIN_FREE_INDICES)
+            {
+                index = m_free_indices.front();
+                m_free_indices.pop_front();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_generations.size());
+                assert(index <= RENDER_ID_MAX_INDEX && "Exceeded the number of scene object IDs. Increase BRR_RENDER_ID_INDEX_BITS.");
+                m_generations.push_back(0);
+            }
+            return MakeRenderId<IdType>(index, m_generations[index]);
+        }
+
+        void ReleaseId(IdType id)
+        {
+            if (id == IdType::NULL_ID)
+            {
+                return;
+            }
+
+            const uint32_t index = GetRenderIdIndex(id);
+            assert(index < m_generations.size() && m_generations[index] == GetRenderIdGeneration(id)
+                   && "Releasing an ID that is not alive.");
+
+            m_generations[index] = (m_generations[index] + 1) & ((uint32_t(1) << RENDER_ID_GENERATION_BITS) - 1);
+            m_free_indices.push_back(index);
+        }
+
+        [[nodiscard]] size_t AliveCount() const { return m_generations.size() - m_free_indices.size(); }
+
+    private:
+        // Current generation of each index.
+        std::vector<uint32_t> m_generations;
+        std::deque<uint32_t> m_free_indices;
+    };
 }
 
 #endif
@@ -2,9 +2,12 @@
 
 #include <thread>
 #include <barrier>
+#include <chrono>
 
 #include <rigtorp/SPSCQueue.h>
 
+#include <Core/Threading/WaitSignal.h>
+
 #include <Renderer/Allocators/SystemsOwner.h>
 #include <Renderer/Internal/CmdList/RenderUpdateCmdGroup.h>
 #include <Renderer/Internal/IdOwner.h>
@@ -24,6 +27,7 @@ using namespace brr::render;
 using namespace internal;
 
 static std::thread s_rendering_thread = std::thread();
+static brr::thread::ThreadConfig s_rendering_thread_config { "brr-render" };
 
 static std::atomic<bool> s_stop_rendering = false;
 
@@ -32,12 +36,19 @@ static rigtorp::SPSCQueue<RenderUpdateCmdGroup> s_render_update_queue{FRAME_LAG}
 static RenderUpdateCmdGroup s_current_render_update_cmds; // RenderUpdateCmdGroup currently owned by render thread
 static RenderUpdateCmdGroup s_current_game_update_cmds;   // RenderUpdateCmdGroup currently owned by game thread
 
-static IdOwner<uint64_t> s_scene_id_generator;
-static IdOwner<uint32_t> s_entity_id_generator;
-static IdOwner<uint32_t> s_camera_id_generator;
-static IdOwner<uint32_t> s_light_id_generator;
+// Signaled after pushing to the respective queue, so the consumer can wait without busy-spinning.
+static brr::thread::WaitSignal s_available_update_signal;
+static brr::thread::WaitSignal s_render_update_signal;
 
-static std::allocator<void> s_cmd_data_allocator = std::allocator<void>();
+// Nanoseconds each thread waited on its last frame synchronization.
+static std::atomic<uint64_t> s_main_thread_wait_ns = 0;
+static std::atomic<uint64_t> s_render_thread_wait_ns = 0;
+
+static IdOwner<uint64_t> s_scene_id_generator;
+// Only used by the main thread. IDs are released when their destroy command is pushed.
+static RecycledIdOwner<EntityID> s_entity_id_generator;
+static RecycledIdOwner<CameraID> s_camera_id_generator;
+static RecycledIdOwner<LightID> s_light_id_generator;
 
 static VulkanRenderDevice* s_render_device = nullptr;
 
@@ -49,27 +60,36 @@ namespace
     {
         ResourceCmdListExecutor resource_cmd_list_executor (render_update_cmds.resource_cmd_list);
         resource_cmd_list_executor.ExecuteCmdList();
-        render_update_cmds.resource_cmd_list.clear();
 
-        SceneRendererCmdListExecutor scene_renderer_cmd_list_executor(render_update_cmds.scene_cmd_list_map);
+        SceneRendererCmdListExecutor scene_renderer_cmd_list_executor(render_update_cmds.scene_cmd_lists);
         scene_renderer_cmd_list_executor.ExecuteCmdList();
-        render_update_cmds.scene_cmd_list_map.clear();
 
         WindowCmdListExecutor window_cmd_list_executor(render_update_cmds.window_cmd_list);
         window_cmd_list_executor.ExecuteCmdList();
-        render_update_cmds.window_cmd_list.clear();
+
+        // Release commands and payloads, so the group goes back to the main thread with an empty arena.
+        render_update_cmds.ResetCommands();
+    }
+
+    uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start_time)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
     }
 
     void RenderThread_SyncUpdate()
     {
         s_available_update_queue.push(std::move(s_current_render_update_cmds));
+        s_available_update_signal.Notify();
 
-        RenderUpdateCmdGroup* front;
-        do
+        const auto wait_start = std::chrono::steady_clock::now();
+        RenderUpdateCmdGroup* front = nullptr;
+        s_render_update_signal.WaitUntil([&front]
         {
             front = s_render_update_queue.front();
-        }
-        while (!front && !s_stop_rendering);
+            return front || s_stop_rendering;
+        });
+        s_render_thread_wait_ns.store(ElapsedNanoseconds(wait_start), std::memory_order_relaxed);
+
         if (!s_stop_rendering)
         {
             s_current_render_update_cmds = std::move(*front);
@@ -101,6 +121,8 @@ namespace
 
     void RenderThreadFunction()
     {
+        brr::thread::ApplyThreadConfig(s_rendering_thread_config);
+
         // Initialization "Frame", used for initializing engine default resources.
         s_render_device->BeginFrame();
         RenderStorageGlobals::material_storage.InitializeDefaults();
@@ -142,6 +164,16 @@ namespace
     }
 }
 
+void RenderThread::SetRenderingThreadConfig(const brr::thread::ThreadConfig& thread_config)
+{
+    if (s_rendering_thread.joinable())
+    {
+        BRR_LogWarn("Rendering thread is already running. Ignoring new thread configuration.");
+        return;
+    }
+    s_rendering_thread_config = thread_config;
+}
+
 void RenderThread::InitializeRenderingThread(RenderAPI render_api,
                                              SDL_Window* main_window)
 {
@@ -154,6 +186,8 @@ void RenderThread::StopRenderingThread()
 {
     BRR_LogDebug("Stopping rendering thread.");
     s_stop_rendering = true;
+    // Wake up the render thread if it is waiting for update commands.
+    s_render_update_signal.Notify();
     s_rendering_thread.join();
 
     // Clear available updates queue (rendering thread is closed)
@@ -177,19 +211,32 @@ void RenderThread::MainThread_SyncUpdate()
     s_current_game_update_cmds.imgui_draw_data_snapshot.SnapUsingSwap(ImGui::GetDrawData(), ImGui::GetTime());
 
     s_render_update_queue.push(std::move(s_current_game_update_cmds));
+    s_render_update_signal.Notify();
 
-    RenderUpdateCmdGroup* front;
-    do
+    const auto wait_start = std::chrono::steady_clock::now();
+    RenderUpdateCmdGroup* front = nullptr;
+    s_available_update_signal.WaitUntil([&front]
     {
         front = s_available_update_queue.front();
-    }
-    while (!front);
+        return front != nullptr;
+    });
+    s_main_thread_wait_ns.store(ElapsedNanoseconds(wait_start), std::memory_order_relaxed);
+
     s_current_game_update_cmds = std::move(*front);
 
     s_available_update_queue.pop();
     s_main_frame_number += 1;
 }
 
+RenderThread::FrameSyncStats RenderThread::GetFrameSyncStats()
+{
+    constexpr float NS_TO_MS = 1.0f / 1000000.0f;
+    FrameSyncStats stats;
+    stats.main_thread_wait_ms   = static_cast<float>(s_main_thread_wait_ns.load(std::memory_order_relaxed)) * NS_TO_MS;
+    stats.render_thread_wait_ms = static_cast<float>(s_render_thread_wait_ns.load(std::memory_order_relaxed)) * NS_TO_MS;
+    return stats;
+}
+
 glm::uvec2 GetSDLWindowDrawableSize(SDL_Window* window_handle)
 {
     int width, height;
@@ -260,11 +307,11 @@ void RenderThread::WindowRenderCmd_SetSceneView(SDL_Window* window_handle,
 // ======== SceneRenderer ========
 // ===============================
 
-uint64_t RenderThread::RenderCmd_InitializeSceneRenderer()
+uint64_t RenderThread::RenderCmd_InitializeSceneRenderer(std::unique_ptr<TransformChannel> transform_channel)
 {
     const uint64_t scene_id              = s_scene_id_generator.GetNewId();
-    SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildCreateSceneRendererCommand();
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildCreateSceneRendererCommand(transform_channel.release());
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     BRR_LogDebug("Pushing RenderCmd to initialize SceneRenderer. Scene ID: {}", scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return scene_id;
@@ -274,7 +321,7 @@ void RenderThread::RenderCmd_DestroySceneRenderer(uint64_t scene_id)
 {
     BRR_LogDebug("Pushing RenderCmd to destroy SceneRenderer. Scene ID: {}", scene_id);
     SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildDestroySceneRendererCommand();
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
@@ -288,11 +335,11 @@ CameraID RenderThread::SceneRenderCmd_CreateCamera(uint64_t scene_id,
                                                    float camera_near,
                                                    float camera_far)
 {
-    const CameraID camera_id       = CameraID(s_camera_id_generator.GetNewId());
+    const CameraID camera_id       = s_camera_id_generator.GetNewId();
     BRR_LogDebug("Pushing RenderCmd to create SceneRenderer Camera. Scene ID: {}. Camera ID: {}", scene_id, static_cast<uint32_t>(camera_id));
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildCreateCameraCommand(
         camera_id, owner_entity, camera_fovy, camera_near, camera_far);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return camera_id;
 }
@@ -301,8 +348,9 @@ void RenderThread::SceneRenderCmd_DestroyCamera(uint64_t scene_id,
                                                 CameraID camera_id)
 {
     BRR_LogDebug("Pushing RenderCmd to destroy SceneRenderer Camera. Scene ID: {}. Camera ID: {}", scene_id, static_cast<uint32_t>(camera_id));
+    s_camera_id_generator.ReleaseId(camera_id);
     SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildDestroyCameraCommand(camera_id);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
@@ -315,7 +363,7 @@ void RenderThread::SceneRenderCmd_UpdateCameraProjection(uint64_t scene_id,
     BRR_LogDebug("Pushing RenderCmd to update SceneRenderer Camera projection. Scene ID: {}. Camera ID: {}", scene_id, static_cast<uint32_t>(camera_id));
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildUpdateCameraProjectionCommand(
         camera_id, camera_fovy, camera_near, camera_far);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
@@ -326,10 +374,10 @@ void RenderThread::SceneRenderCmd_UpdateCameraProjection(uint64_t scene_id,
 EntityID RenderThread::SceneRenderCmd_CreateEntity(uint64_t scene_id,
                                                    const glm::mat4& entity_transform)
 {
-    EntityID entity_id                   = EntityID(s_entity_id_generator.GetNewId());
+    EntityID entity_id                   = s_entity_id_generator.GetNewId();
     BRR_LogDebug("Pushing RenderCmd to create SceneRenderer Entity. Scene ID: {}. Entity ID: {}", scene_id, static_cast<uint32_t>(entity_id));
     SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildCreateEntityCommand(entity_id, entity_transform);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return entity_id;
 }
@@ -338,18 +386,42 @@ void RenderThread::SceneRenderCmd_DestroyEntity(uint64_t scene_id,
                                                 EntityID entity_id)
 {
     BRR_LogDebug("Pushing RenderCmd to destroy SceneRenderer Entity. Scene ID: {}. Entity ID: {}", scene_id, static_cast<uint32_t>(entity_id));
+    s_entity_id_generator.ReleaseId(entity_id);
     SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildDestroyEntityCommand(entity_id);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
-void RenderThread::SceneRenderCmd_UpdateEntityTransform(uint64_t scene_id,
-                                                        EntityID entity_id,
-                                                        const glm::mat4& entity_transform)
+void RenderThread::SceneRenderCmd_DestroyEntities(uint64_t scene_id,
+                                                  std::span<const EntityID> entity_ids,
+                                                  std::span<const CameraID> camera_ids,
+                                                  std::span<const LightID> light_ids)
+{
+    BRR_LogDebug("Pushing RenderCmd to destroy {} SceneRenderer Entities, {} Cameras and {} Lights. Scene ID: {}",
+                 entity_ids.size(), camera_ids.size(), light_ids.size(), scene_id);
+    for (EntityID entity_id : entity_ids)
+    {
+        s_entity_id_generator.ReleaseId(entity_id);
+    }
+    for (CameraID camera_id : camera_ids)
+    {
+        s_camera_id_generator.ReleaseId(camera_id);
+    }
+    for (LightID light_id : light_ids)
+    {
+        s_light_id_generator.ReleaseId(light_id);
+    }
+    SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildDestroyEntitiesCommand(*s_current_game_update_cmds.cmd_arena,
+                                                                                             entity_ids, camera_ids, light_ids);
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
+    scene_cmd_list.push_back(scene_cmd);
+}
+
+void RenderThread::SceneRenderCmd_UpdateEntityTransforms(uint64_t scene_id,
+                                                         uint32_t transform_buffer_index)
 {
-    BRR_LogDebug("Pushing RenderCmd to update SceneRenderer Entity transform. Scene ID: {}. Entity ID: {}", scene_id, static_cast<uint32_t>(entity_id));
-    SceneRendererCommand scene_cmd = SceneRendererCommand::BuildUpdateEntityTransformCommand(entity_id, entity_transform);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCommand scene_cmd = SceneRendererCommand::BuildUpdateEntityTransformsCommand(transform_buffer_index);
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
@@ -359,7 +431,7 @@ void RenderThread::SceneRenderCmd_AppendSurfaceToEntity(uint64_t scene_id,
 {
     BRR_LogDebug("Pushing RenderCmd to append Surface to SceneRenderer Entity. Scene ID: {}. Entity ID: {}. Surface ID: {}", scene_id, static_cast<uint32_t>(entity_id), static_cast<size_t>(surface_id));
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildAppendSurfaceCommand(entity_id, surface_id);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
@@ -375,7 +447,7 @@ TextureID RenderThread::ResourceCmd_CreateTexture2D(const void* image_data,
     TextureID texture_id = RenderStorageGlobals::texture_storage.AllocateTexture();
     BRR_LogDebug("Pushing RenderCmd to create Texture2D. Texture2D ID: {}", static_cast<size_t>(texture_id));
     ResourceCommand resource_cmd = ResourceCommand::BuildCreateTexture2DCommand(
-        texture_id, image_data, width, height, image_format);
+        *s_current_game_update_cmds.cmd_arena, texture_id, image_data, width, height, image_format);
     ResourceCmdList& resource_cmd_list = s_current_game_update_cmds.resource_cmd_list;
     resource_cmd_list.push_back(resource_cmd);
     return texture_id;
@@ -434,7 +506,8 @@ SurfaceID RenderThread::ResourceCmd_CreateSurface(void* vertex_buffer_data,
 {
     SurfaceID surface_id = RenderStorageGlobals::mesh_storage.AllocateResource();
     BRR_LogDebug("Pushing RenderCmd to create Render Surface. Surface ID: {}", static_cast<size_t>(surface_id));
-    ResourceCommand resource_cmd = ResourceCommand::BuildCreateSurfaceCommand(surface_id, vertex_buffer_data,
+    ResourceCommand resource_cmd = ResourceCommand::BuildCreateSurfaceCommand(*s_current_game_update_cmds.cmd_arena,
+                                                                              surface_id, vertex_buffer_data,
                                                                               vertex_buffer_size, index_buffer_data,
                                                                               index_buffer_size, surface_material);
 
@@ -480,10 +553,10 @@ LightID RenderThread::SceneRenderCmd_CreatePointLight(uint64_t scene_id,
                                                       const glm::vec3& color,
                                                       float intensity)
 {
-    LightID light_id               = LightID(s_light_id_generator.GetNewId());
+    LightID light_id               = s_light_id_generator.GetNewId();
     SceneRendererCommand scene_cmd =
         SceneRendererCommand::BuildCreatePointLightCommand(light_id, owner_entity_id, color, intensity);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return light_id;
 }
@@ -493,10 +566,10 @@ LightID RenderThread::SceneRenderCmd_CreateDirectionalLight(uint64_t scene_id,
                                                             const glm::vec3& color,
                                                             float intensity)
 {
-    LightID light_id               = LightID(s_light_id_generator.GetNewId());
+    LightID light_id               = s_light_id_generator.GetNewId();
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildCreateDirectionalLightCommand(
         light_id, owner_entity_id, color, intensity);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return light_id;
 }
@@ -507,10 +580,10 @@ LightID RenderThread::SceneRenderCmd_CreateSpotLight(uint64_t scene_id,
                                                      float intensity,
                                                      float cutoff_angle)
 {
-    LightID light_id               = LightID(s_light_id_generator.GetNewId());
+    LightID light_id               = s_light_id_generator.GetNewId();
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildCreateSpotLightCommand(
         light_id, owner_entity_id, color, intensity, cutoff_angle);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return light_id;
 }
@@ -520,10 +593,10 @@ LightID RenderThread::SceneRenderCmd_CreateAmbientLight(uint64_t scene_id,
                                                         const glm::vec3& color,
                                                         float intensity)
 {
-    LightID light_id               = LightID(s_light_id_generator.GetNewId());
+    LightID light_id               = s_light_id_generator.GetNewId();
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildCreateAmbientLightCommand(
         light_id, owner_entity_id, color, intensity);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
     return light_id;
 }
@@ -535,14 +608,15 @@ void RenderThread::SceneRenderCmd_UpdateLight(uint64_t scene_id,
                                               float cutoff_angle)
 {
     SceneRendererCommand scene_cmd = SceneRendererCommand::BuildUpdateLightCommand(light_id, color, intensity, cutoff_angle);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
 
 void RenderThread::SceneRenderCmd_DestroyLight(uint64_t scene_id,
                                                LightID light_id)
 {
+    s_light_id_generator.ReleaseId(light_id);
     SceneRendererCommand scene_cmd       = SceneRendererCommand::BuildDestroyLightCommand(light_id);
-    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.scene_cmd_list_map[scene_id];
+    SceneRendererCmdList& scene_cmd_list = s_current_game_update_cmds.GetSceneCmdList(scene_id);
     scene_cmd_list.push_back(scene_cmd);
 }
@@ -2,10 +2,12 @@
 #define BRR_RENDERTHREAD_H
 
 #include <Core/thirdpartiesInc.h>
+#include <Core/Threading/ThreadConfig.h>
 
 #include <Renderer/RenderEnums.h>
 #include <Renderer/RenderingResourceIDs.h>
 #include <Renderer/SceneObjectsIDs.h>
+#include <Renderer/TransformChannel.h>
 #include <Visualization/Resources/Material.h>
 
 namespace brr::render
@@ -19,6 +21,9 @@ namespace brr::render
     {
     public:
 
+        // Set the configuration applied by the rendering thread when it starts. Must be called before `InitializeRenderingThread`.
+        static void SetRenderingThreadConfig(const thread::ThreadConfig& thread_config);
+
         static void InitializeRenderingThread(RenderAPI render_api, SDL_Window* main_window);
 
         static void StopRenderingThread();
@@ -28,6 +33,17 @@ namespace brr::render
         // but no rendering command should be called before call to `MainThread_SyncEndUpdate`
         static void MainThread_SyncUpdate();
 
+        struct FrameSyncStats
+        {
+            // Time the main thread waited for an available update command group on its last sync.
+            float main_thread_wait_ms   = 0.0f;
+            // Time the render thread waited for the main thread update commands on its last sync.
+            float render_thread_wait_ms = 0.0f;
+        };
+
+        // Get how long each thread waited for the other on its last frame synchronization.
+        static FrameSyncStats GetFrameSyncStats();
+
 
         /*******************
          * Window Commands *
@@ -43,7 +59,9 @@ namespace brr::render
          * Scene Renderer Commands *
          ***************************/
 
-        static uint64_t RenderCmd_InitializeSceneRenderer();
+        // The SceneRenderer takes ownership of 'transform_channel'. The main thread can keep writing into it until
+        // it calls `RenderCmd_DestroySceneRenderer`.
+        static uint64_t RenderCmd_InitializeSceneRenderer(std::unique_ptr<TransformChannel> transform_channel);
         static void RenderCmd_DestroySceneRenderer(uint64_t scene_id);
 
         /*******************
@@ -68,7 +86,13 @@ namespace brr::render
 
         static EntityID SceneRenderCmd_CreateEntity(uint64_t scene_id, const glm::mat4& entity_transform = glm::mat4());
         static void SceneRenderCmd_DestroyEntity(uint64_t scene_id, EntityID entity_id);
-        static void SceneRenderCmd_UpdateEntityTransform(uint64_t scene_id, EntityID entity_id, const glm::mat4& entity_transform);
+        // Destroy the entities together with the given cameras and lights, which are destroyed first.
+        static void SceneRenderCmd_DestroyEntities(uint64_t scene_id,
+                                                   std::span<const EntityID> entity_ids,
+                                                   std::span<const CameraID> camera_ids = {},
+                                                   std::span<const LightID> light_ids = {});
+        // Apply the transforms written in the buffer of the scene's TransformChannel returned by `TransformChannel::Publish`.
+        static void SceneRenderCmd_UpdateEntityTransforms(uint64_t scene_id, uint32_t transform_buffer_index);
 
         static void SceneRenderCmd_AppendSurfaceToEntity(uint64_t scene_id, EntityID entity_id, SurfaceID surface_id);
 
@@ -1,6 +1,15 @@
 #ifndef BRR_SCENEOBJECTSIDS_H
 #define BRR_SCENEOBJECTSIDS_H
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifndef BRR_RENDER_ID_INDEX_BITS
+// Number of bits of a scene object ID used by the index. The remaining bits store the index generation.
+#define BRR_RENDER_ID_INDEX_BITS 20
+#endif
+
 namespace brr::render
 {
     enum class CameraID : uint32_t
@@ -22,6 +31,50 @@ namespace brr::render
     {
         NULL_ID = static_cast<uint32_t>(-1)
     };
+
+    /*
+     * Scene object IDs store a dense index in the low bits and the generation of the index in the high bits.
+     * Indices are recycled when objects are destroyed, and the generation distinguishes the objects that used the
+     * same index. The last index is never used, so NULL_ID never matches a valid ID.
+     */
+    static constexpr uint32_t RENDER_ID_INDEX_BITS      = BRR_RENDER_ID_INDEX_BITS;
+    static constexpr uint32_t RENDER_ID_GENERATION_BITS = 32 - RENDER_ID_INDEX_BITS;
+    static constexpr uint32_t RENDER_ID_INDEX_MASK      = (uint32_t(1) << RENDER_ID_INDEX_BITS) - 1;
+    static constexpr uint32_t RENDER_ID_MAX_INDEX       = RENDER_ID_INDEX_MASK - 1;
+
+    static_assert(RENDER_ID_INDEX_BITS >= 8 && RENDER_ID_INDEX_BITS <= 28, "BRR_RENDER_ID_INDEX_BITS must be between 8 and 28.");
+
+    template <typename IdType>
+        requires std::is_enum_v<IdType>
+    constexpr IdType MakeRenderId(uint32_t index, uint32_t generation)
+    {
+        return IdType((generation << RENDER_ID_INDEX_BITS) | (index & RENDER_ID_INDEX_MASK));
+    }
+
+    template <typename IdType>
+        requires std::is_enum_v<IdType>
+    constexpr uint32_t GetRenderIdIndex(IdType id)
+    {
+        return static_cast<uint32_t>(id) & RENDER_ID_INDEX_MASK;
+    }
+
+    template <typename IdType>
+        requires std::is_enum_v<IdType>
+    constexpr uint32_t GetRenderIdGeneration(IdType id)
+    {
+        return static_cast<uint32_t>(id) >> RENDER_ID_INDEX_BITS;
+    }
+
+    /**
+     * \brief Returns the index of a scene object ID. Used as key index of ContiguousPool, so the generation bits don't
+     *        spread the IDs over the sparse pages.
+     */
+    struct RenderIdIndex
+    {
+        template <typename IdType>
+            requires std::is_enum_v<IdType>
+        constexpr size_t operator()(IdType id) const noexcept { return GetRenderIdIndex(id); }
+    };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,8 @@
 #include "SceneRenderer.h"
 
+#include <algorithm>
 #include <ranges>
+#include <utility>
 
 #include <Renderer/Storages/RenderStorageGlobals.h>
 #include <Renderer/Vulkan/VulkanRenderDevice.h>
@@ -17,23 +19,25 @@ struct CameraUniform
     glm::mat4 projection_view{1.f};
 };
 
-struct Transform3DUniform
-{
-    glm::mat4 model_matrix;
-};
-
 constexpr uint32_t scene_descriptor_set_index    = 0;
 constexpr uint32_t model_descriptor_set_index    = 1;
 constexpr uint32_t material_descriptor_set_index = 2;
 
+// Initial number of objects of the object buffers, and of instances of the viewport instance buffers.
+constexpr uint32_t min_object_buffer_capacity   = 1024;
+constexpr uint32_t min_instance_buffer_capacity = 256;
+
 namespace brr::render
 {
-    static internal::IdOwner<uint32_t> s_viewport_id_owner;
+    // Viewports are only created and destroyed by the render thread.
+    static internal::RecycledIdOwner<ViewportID> s_viewport_id_owner;
 
-    SceneRenderer::SceneRenderer()
-        : m_render_device(VKRD::GetSingleton())
+    SceneRenderer::SceneRenderer(std::unique_ptr<TransformChannel> transform_channel)
+        : m_render_device(VKRD::GetSingleton()),
+          m_transform_channel(std::move(transform_channel))
     {
         assert(m_render_device && "Can't create SceneRenderer without VulkanRenderDevice.");
+        assert(m_transform_channel && "Can't create SceneRenderer without TransformChannel.");
         BRR_LogInfo("Creating SceneRenderer");
 
         {
@@ -46,6 +50,7 @@ namespace brr::render
         }
 
         SetupSceneUniforms();
+        SetupObjectBuffers();
 
         m_image = AssetManager::GetOrCreateAsset<vis::Image>("Resources/UV_Grid.png");
 
@@ -127,49 +132,63 @@ namespace brr::render
     void SceneRenderer::CreateEntity(EntityID entity_id,
                                      const glm::mat4& entity_transform)
     {
-        if (m_entities_map.contains(entity_id))
+        const uint32_t entity_slot = m_entities.Add(entity_id, entity_transform);
+        if (entity_slot == internal::EntityRenderStorage::INVALID_SLOT)
         {
             BRR_LogError("Can't create SceneRenderer Entity (ID: {}) because this entity already exists.",
                          static_cast<uint32_t>(entity_id));
             return;
         }
-
-        auto [entity_info_it, success] = m_entities_map.emplace(entity_id, EntityInfo{});
-
-        entity_info_it->second.current_matrix = entity_transform;
-        SetupEntityUniforms(entity_info_it->second);
     }
 
     void SceneRenderer::DestroyEntity(EntityID entity_id)
     {
-        if (!m_entities_map.contains(entity_id))
-        {
-            BRR_LogError("Can't destroy SceneRenderer Entity (ID: {}) because this entity doesn't exist.",
-                         static_cast<uint32_t>(entity_id));
-            return;
-        }
+        DestroyEntities({&entity_id, 1});
+    }
 
-        auto entity_node = m_entities_map.extract(entity_id);
+    void SceneRenderer::DestroyEntities(std::span<const EntityID> entity_ids)
+    {
+        // Owners of the cached surfaces are updated once per surface, after every entity is visited.
+        std::vector<EntityID> destroyed_entities;
+        std::vector<SurfaceID> owned_surfaces;
+        destroyed_entities.reserve(entity_ids.size());
 
-        for (DescriptorSetHandle& descriptor_set_handle : entity_node.mapped().descriptor_sets)
+        for (EntityID entity_id : entity_ids)
         {
-            m_render_device->DescriptorSet_Destroy(descriptor_set_handle);
-        }
+            const uint32_t entity_slot = m_entities.GetSlot(entity_id);
+            if (entity_slot == internal::EntityRenderStorage::INVALID_SLOT)
+            {
+                BRR_LogError("Can't destroy SceneRenderer Entity (ID: {}) because this entity doesn't exist.",
+                             static_cast<uint32_t>(entity_id));
+                continue;
+            }
 
-        if (entity_node.mapped().attached_light != LightID::NULL_ID)
-        {
-            LightID light_id = entity_node.mapped().attached_light;
-            DestroyLight(light_id);
+            if (m_entities.attached_lights[entity_slot] != LightID::NULL_ID)
+            {
+                LightID light_id = m_entities.attached_lights[entity_slot];
+                DestroyLight(light_id);
+            }
+
+            const auto entity_surfaces = m_entities.GetSurfaces(entity_slot);
+            owned_surfaces.insert(owned_surfaces.end(), entity_surfaces.begin(), entity_surfaces.end());
+            destroyed_entities.push_back(entity_id);
         }
 
+        std::ranges::sort(destroyed_entities);
+        std::ranges::sort(owned_surfaces, {}, [](const SurfaceID& surface_id) { return static_cast<uint64_t>(surface_id); });
+        owned_surfaces.erase(std::ranges::unique(owned_surfaces).begin(), owned_surfaces.end());
+
         // Update cached surfaces and materials.
-        for (SurfaceID surface_id : entity_node.mapped().surfaces)
+        for (SurfaceID surface_id : owned_surfaces)
         {
             if (m_cached_surfaces.Contains(surface_id))
             {
-                // Erase entity from surface owner nodes.
+                // Erase destroyed entities from surface owner nodes.
                 SurfaceRenderData& surface_cached_data = m_cached_surfaces.Get(surface_id);
-                std::erase(surface_cached_data.m_owner_nodes, entity_id);
+                std::erase_if(surface_cached_data.m_owner_nodes, [&destroyed_entities](EntityID owner_entity)
+                {
+                    return std::ranges::binary_search(destroyed_entities, owner_entity);
+                });
 
                 // If surface has no more owner nodes, remove it from cached surfaces.
                 if (surface_cached_data.m_owner_nodes.empty())
@@ -179,29 +198,48 @@ namespace brr::render
                 }
             }
         }
+
+        m_entity_bvh.RemoveBatch(destroyed_entities);
+        for (EntityID entity_id : destroyed_entities)
+        {
+            m_entities.Remove(entity_id);
+        }
     }
 
-    void SceneRenderer::UpdateEntityTransform(EntityID entity_id,
-                                              const glm::mat4& entity_transform)
+    void SceneRenderer::UpdateEntityTransforms(uint32_t transform_buffer_index)
     {
-        auto entity_it = m_entities_map.find(entity_id);
-        if (entity_it == m_entities_map.end())
+        bool lights_changed = false;
+        m_transform_channel->Consume(transform_buffer_index,
+            [&](std::span<const EntityID> entity_ids, std::span<const glm::mat4> entity_transforms)
         {
-            BRR_LogError("Can't update SceneRenderer Entity (ID: {}) transform because this entity doesn't exist.",
-                         static_cast<uint32_t>(entity_id));
-            return;
-        }
+            for (uint32_t idx = 0; idx < entity_transforms.size(); idx++)
+            {
+                // Writes of destroyed entities are skipped. The generation of the ID is checked, so a write of a
+                // destroyed entity is never applied to the entity that reused its index.
+                const uint32_t entity_slot = m_entities.GetSlot(entity_ids[idx]);
+                if (entity_slot == internal::EntityRenderStorage::INVALID_SLOT)
+                {
+                    continue;
+                }
 
-        // Change current transform and signal uniforms as dirty.
-        entity_it->second.current_matrix = entity_transform;
-        MarkEntityDirty(entity_id, entity_it->second, false, true);
+                // Change current transform and signal uniforms as dirty.
+                const glm::mat4& entity_transform  = entity_transforms[idx];
+                m_entities.transforms[entity_slot] = entity_transform;
+                SetEntityWorldBounds(entity_slot, m_entities.local_bounds[entity_slot].Transformed(entity_transform));
+                MarkEntityDirty(entity_slot, false, true);
 
-        if (entity_it->second.attached_light != LightID::NULL_ID)
-        {
-            Light& light = m_scene_lights.Get(entity_it->second.attached_light);
-            light.light_position = glm::vec3(entity_transform[3]);
-            light.light_direction = glm::vec3(entity_transform[2]);
+                if (m_entities.attached_lights[entity_slot] != LightID::NULL_ID)
+                {
+                    Light& light = m_scene_lights.Get(m_entities.attached_lights[entity_slot]);
+                    light.light_position  = glm::vec3(entity_transform[3]);
+                    light.light_direction = glm::vec3(entity_transform[2]);
+                    lights_changed = true;
+                }
+            }
+        });
 
+        if (lights_changed)
+        {
             m_scene_uniform_info.m_light_storage_dirty.fill(true);
         }
     }
@@ -209,8 +247,8 @@ namespace brr::render
     void SceneRenderer::AppendSurfaceToEntity(SurfaceID surface_id,
                                               EntityID owner_entity)
     {
-        auto entity_it = m_entities_map.find(owner_entity);
-        if (entity_it == m_entities_map.end())
+        const uint32_t entity_slot = m_entities.GetSlot(owner_entity);
+        if (entity_slot == internal::EntityRenderStorage::INVALID_SLOT)
         {
             BRR_LogError("Can't append Surface (ID: {}) to SceneRenderer Entity (ID: {}) because this entity doesn't exist.",
                          static_cast<uint64_t>(surface_id), static_cast<uint32_t>(owner_entity));
@@ -225,16 +263,16 @@ namespace brr::render
             return;
         }
 
-        EntityInfo& entity_info = entity_it->second;
-        if (std::find(entity_info.surfaces.begin(), entity_info.surfaces.end(), surface_id) != entity_info.surfaces.end())
+        if (!m_entities.AppendSurface(entity_slot, surface_id))
         {
             BRR_LogError("Can't append Surface (ID: {}) to SceneRenderer Entity (ID: {}) because this Surface is already assigned to this entity.",
                          static_cast<uint64_t>(surface_id), static_cast<uint32_t>(owner_entity));
             return;
         }
 
-        entity_info.surfaces.push_back(surface_id);
-        MarkEntityDirty(owner_entity, entity_info, true, false);
+        // Appending a surface can only grow the bounds, so they are updated without a full rebuild.
+        m_entities.local_bounds[entity_slot].Expand(render_surface->m_aabb);
+        SetEntityWorldBounds(entity_slot, m_entities.local_bounds[entity_slot].Transformed(m_entities.transforms[entity_slot]));
         BRR_LogInfo("Appended Surface (ID: {}) to Entity (ID: {}).", static_cast<uint64_t>(surface_id), static_cast<uint32_t>(owner_entity));
 
         MaterialID surface_material_id = render_surface->m_material_id.IsValid() ?
@@ -253,6 +291,7 @@ namespace brr::render
             render_data.m_index_buffer_handle = render_surface->m_index_buffer;
             render_data.m_num_vertices = render_surface->num_vertices;
             render_data.m_num_indices = render_surface->num_indices;
+            render_data.m_bounds = render_surface->m_aabb;
 
             // Material Data
             render_data.m_material_id = surface_material_id;
@@ -275,14 +314,13 @@ namespace brr::render
             // Mark entities surfaces as dirty. Delete SurfaceID from entity surfaces if surface was removed.
             for (auto& owner_node : surface_cached_data.m_owner_nodes)
             {
-                auto entity_it = m_entities_map.find(owner_node);
-                if (entity_it != m_entities_map.end())
+                const uint32_t entity_slot = m_entities.GetSlot(owner_node);
+                if (entity_slot != internal::EntityRenderStorage::INVALID_SLOT)
                 {
-                    EntityInfo& entity_info = entity_it->second;
-                    MarkEntityDirty(owner_node, entity_info, true, false);
+                    MarkEntityDirty(entity_slot, true, false);
                     if (is_removed)
                     {
-                        std::erase(entity_info.surfaces, surface_id);
+                        m_entities.RemoveSurface(entity_slot, surface_id);
                     }
                 }
             }
@@ -294,6 +332,7 @@ namespace brr::render
                 surface_cached_data.m_index_buffer_handle = render_surface->m_index_buffer;
                 surface_cached_data.m_num_vertices = render_surface->num_vertices;
                 surface_cached_data.m_num_indices = render_surface->num_indices;
+                surface_cached_data.m_bounds = render_surface->m_aabb;
                 // TODO: Handle material change.
                 if (surface_cached_data.m_material_id != render_surface->m_material_id)
                 {
@@ -455,22 +494,21 @@ namespace brr::render
 
         m_scene_lights.RemoveObject(light_id);
 
-        auto owner_it = m_light_owners.find(light_id);
-        if (owner_it != m_light_owners.end())
+        if (m_light_owners.Contains(light_id))
         {
-            EntityID owner_entity = owner_it->second;
-            auto entity_it        = m_entities_map.find(owner_entity);
-            if (entity_it != m_entities_map.end())
+            EntityID owner_entity = m_light_owners.Get(light_id);
+            const uint32_t entity_slot = m_entities.GetSlot(owner_entity);
+            if (entity_slot != internal::EntityRenderStorage::INVALID_SLOT)
             {
-                entity_it->second.attached_light = LightID::NULL_ID;
+                m_entities.attached_lights[entity_slot] = LightID::NULL_ID;
             }
             else
             {
                 BRR_LogWarn("Light (ID: {}) owner entity (ID: {}) not found in entities map when destroying light.",
                             static_cast<uint32_t>(light_id), static_cast<uint32_t>(owner_entity));
             }
+            m_light_owners.RemoveObject(light_id);
         }
-        m_light_owners.erase(light_id);
 
         m_scene_uniform_info.m_light_storage_dirty.fill(true);
         m_scene_uniform_info.m_light_storage_size_changed.fill(true);
@@ -491,7 +529,7 @@ namespace brr::render
                                                                                ImageUsage::DepthStencilAttachmentImage,
                                                                                DataFormat::D32_Float);
         }
-        ViewportID new_viewport_id = static_cast<ViewportID>(s_viewport_id_owner.GetNewId());
+        ViewportID new_viewport_id = s_viewport_id_owner.GetNewId();
         m_viewports.AddObject(new_viewport_id, std::move(viewport));
 
         Viewport& new_viewport = m_viewports.Get(new_viewport_id);
@@ -542,9 +580,11 @@ namespace brr::render
         {
             m_render_device->DestroyTexture2D(viewport.color_attachment[idx]);
             m_render_device->DestroyTexture2D(viewport.depth_attachment[idx]);
+            m_render_device->DescriptorSet_Destroy(viewport.instance_descriptor_sets[idx]);
         }
 
         m_viewports.RemoveObject(viewport_id);
+        s_viewport_id_owner.ReleaseId(viewport_id);
         BRR_LogInfo("Destroyed Viewport. Viewport ID: {}", static_cast<uint32_t>(viewport_id));
     }
 
@@ -559,6 +599,16 @@ namespace brr::render
         return viewport.camera_id;
     }
 
+    SceneRenderer::CullingStats SceneRenderer::GetViewportCullingStats(ViewportID viewport_id) const
+    {
+        if (!m_viewports.Contains(viewport_id))
+        {
+            BRR_LogError("Getting culling stats from Viewport (ID: {}) that does not exist in this SceneRenderer.", uint32_t(viewport_id));
+            return {};
+        }
+        return m_viewports.Get(viewport_id).culling_stats;
+    }
+
     void SceneRenderer::SetViewportCameraID(ViewportID viewport_id,
                                             CameraID camera_id)
     {
@@ -585,39 +635,10 @@ namespace brr::render
         m_current_frame  = m_render_device->GetCurrentFrameNumber();
         m_current_buffer = m_render_device->GetCurrentFrameBufferIndex();
 
-        // Update dirty entities
-        std::set<EntityID> updated_entities;
-        std::vector<EntityID> entities_still_dirty;
-        for (auto& entity_id : m_dirty_entities)
-        {
-            EntityInfo& entity = m_entities_map.at(entity_id);
-            if (entity.transform_dirty[m_current_buffer])
-            {
-                entity.uniform_buffers[m_current_buffer].Map();
-                entity.uniform_buffers[m_current_buffer].WriteToBuffer(
-                    &entity.current_matrix, sizeof(glm::mat4));
-                entity.uniform_buffers[m_current_buffer].Unmap();
-
-                entity.transform_dirty[m_current_buffer] = false;
-                updated_entities.emplace(entity_id);
-            }
-
-            if (entity.surfaces_dirty)
-            {
-                // TODO: maintain AABB updated.
-                entity.surfaces_dirty = false;
-            }
-
-            // If entity still has dirty buffer, keep it in the dirty list for next frame update.
-            if (std::ranges::any_of(entity.transform_dirty, [](bool is_dirty) {return is_dirty;}))
-            {
-
-                entities_still_dirty.push_back(entity_id);
-            }
-        }
-        m_dirty_entities = std::move(entities_still_dirty);
+        const uint8_t current_buffer_bit = 1u << m_current_buffer;
 
-        // Update viewports and cameras
+        // Update viewports and cameras.
+        // Done before updating the entities, since cameras are also updated when their owner entity transform is dirty.
         for (Viewport& viewport : m_viewports)
         {
             if (!m_cameras.Contains(viewport.camera_id))
@@ -626,18 +647,22 @@ namespace brr::render
                 continue; 
             }
             CameraInfo& camera_info = m_cameras.Get(viewport.camera_id);
-            if (viewport.camera_uniform_dirty[m_current_buffer] || updated_entities.contains(camera_info.owner_entity))
+            const uint32_t owner_slot = m_entities.GetSlot(camera_info.owner_entity);
+            const bool owner_updated = owner_slot != internal::EntityRenderStorage::INVALID_SLOT
+                                       && (m_entities.dirty_flags[owner_slot] & current_buffer_bit);
+            if (viewport.camera_uniform_dirty[m_current_buffer] || owner_updated)
             {
                 float aspect                = (float)viewport.width / (float)viewport.height;
                 glm::mat4 projection_matrix = glm::perspective(camera_info.camera_fov_y, aspect, camera_info.camera_near,
                                                                camera_info.camera_far);
 
-                EntityInfo& entity    = m_entities_map[camera_info.owner_entity];
-                glm::mat4 view_matrix = glm::inverse(entity.current_matrix);
-                glm::vec3 camera_position = glm::vec3(entity.current_matrix[3]);
+                const glm::mat4& owner_transform = GetEntityTransform(camera_info.owner_entity);
+                glm::mat4 view_matrix = glm::inverse(owner_transform);
+                glm::vec3 camera_position = glm::vec3(owner_transform[3]);
 
                 CameraUniform camera_uniform;
                 camera_uniform.projection_view = projection_matrix * view_matrix;
+                viewport.frustum = Frustum::FromProjectionView(camera_uniform.projection_view);
                 viewport.camera_uniform_buffers[m_current_buffer].Map();
                 viewport.camera_uniform_buffers[m_current_buffer].WriteToBuffer(
                     &camera_uniform, sizeof(CameraUniform));
@@ -647,6 +672,60 @@ namespace brr::render
                 viewport.camera_uniform_dirty[m_current_buffer] = false;
             }
         }
+
+        // Update dirty entities. Linear sweep over the dirty flags, only touching the state of dirty entities.
+        // Entities that got surfaces are inserted in the BVH in a single batch.
+        std::vector<EntityID> bvh_inserted_entities;
+        std::vector<AABBB> bvh_inserted_bounds;
+        const uint32_t entities_count = m_entities.Size();
+        ReserveObjectBuffer(entities_count);
+        ObjectData* mapped_objects = m_object_buffer_info.m_mapped_objects[m_current_buffer];
+        for (uint32_t entity_slot = 0; entity_slot < entities_count; ++entity_slot)
+        {
+            uint8_t& dirty_flags = m_entities.dirty_flags[entity_slot];
+            if (dirty_flags == 0)
+            {
+                continue;
+            }
+
+            if (dirty_flags & current_buffer_bit)
+            {
+                mapped_objects[entity_slot].model_matrix = m_entities.transforms[entity_slot];
+            }
+
+            if (dirty_flags & internal::EntityRenderStorage::SURFACES_DIRTY_BIT)
+            {
+                UpdateEntityBounds(entity_slot);
+            }
+
+            if (dirty_flags & internal::EntityRenderStorage::BOUNDS_DIRTY_BIT)
+            {
+                // Only entities with surfaces are drawn, so only they are part of the BVH.
+                const EntityID entity_id  = m_entities.ids[entity_slot];
+                const bool has_surfaces   = !m_entities.GetSurfaces(entity_slot).empty();
+                const bool is_in_bvh      = m_entity_bvh.Contains(entity_id);
+                if (has_surfaces && is_in_bvh)
+                {
+                    m_entity_bvh.Update(entity_id, m_entities.bounds[entity_slot]);
+                }
+                else if (has_surfaces)
+                {
+                    bvh_inserted_entities.push_back(entity_id);
+                    bvh_inserted_bounds.push_back(m_entities.bounds[entity_slot]);
+                }
+                else if (is_in_bvh)
+                {
+                    m_entity_bvh.Remove(entity_id);
+                }
+            }
+
+            // Transforms of the other frame buffers stay dirty until their frames are updated.
+            dirty_flags &= ~(current_buffer_bit | internal::EntityRenderStorage::SURFACES_DIRTY_BIT
+                             | internal::EntityRenderStorage::BOUNDS_DIRTY_BIT);
+        }
+
+        m_entity_bvh.InsertBatch(bvh_inserted_entities, bvh_inserted_bounds);
+        m_entity_bvh.RebuildIfDegraded();
         
         // Update lights
         if (m_scene_uniform_info.m_light_storage_dirty[m_current_buffer])
@@ -692,46 +771,81 @@ namespace brr::render
         // Viewport uniform (camera matrix)
         m_render_device->Bind_DescriptorSet(m_graphics_pipeline, viewport.camera_descriptor_sets[m_current_buffer], 1);
 
+        // Gather the surfaces of the entities that may be visible, skipping the BVH subtrees outside the frustum.
+        m_draw_items.clear();
+        m_entity_bvh.QueryFrustum(viewport.frustum, [this](EntityID entity_id)
+        {
+            const uint32_t entity_slot = m_entities.GetSlot(entity_id);
+            for (SurfaceID surface_id : m_entities.GetSurfaces(entity_slot))
+            {
+                if (m_cached_surfaces.Contains(surface_id))
+                {
+                    m_draw_items.push_back({m_cached_surfaces.Get(surface_id).m_material_id, surface_id, entity_slot});
+                }
+            }
+        });
+
+        // Sort by material and surface, so each material and vertex buffer is bound once, and the owners of a surface
+        // are contiguous.
+        std::ranges::sort(m_draw_items, {}, [](const DrawItem& draw_item)
+        {
+            return std::pair(static_cast<uint64_t>(draw_item.material_id), static_cast<uint64_t>(draw_item.surface_id));
+        });
+
+        // Object index of each instance, in draw order. Each run of draw items with the same surface is one instanced
+        // draw, and the first instance of the draw indexes its run. Objects are stored by entity slot.
+        m_instance_object_indices.clear();
+        m_instance_object_indices.reserve(m_draw_items.size());
+        for (const DrawItem& draw_item : m_draw_items)
+        {
+            m_instance_object_indices.push_back(draw_item.entity_slot);
+        }
+        WriteViewportInstances(viewport, m_instance_object_indices);
+
+        // Instance storage (object data and instance object indices)
+        m_render_device->Bind_DescriptorSet(m_graphics_pipeline, viewport.instance_descriptor_sets[m_current_buffer], 3);
+
+        viewport.culling_stats.drawn_objects  = static_cast<uint32_t>(m_draw_items.size());
+        viewport.culling_stats.culled_objects = m_entities.SurfacesCount() - viewport.culling_stats.drawn_objects;
+        viewport.culling_stats.draw_calls     = 0;
+
         MaterialID last_material_id = MaterialID();
-        for (SurfaceRenderData& render_data : m_cached_surfaces)
+        const uint32_t draw_items_count = static_cast<uint32_t>(m_draw_items.size());
+        uint32_t run_end = 0;
+        for (uint32_t run_begin = 0; run_begin < draw_items_count; run_begin = run_end)
         {
+            const DrawItem& draw_item = m_draw_items[run_begin];
+            run_end = run_begin + 1;
+            while (run_end < draw_items_count && m_draw_items[run_end].surface_id == draw_item.surface_id
+                   && m_draw_items[run_end].material_id == draw_item.material_id)
+            {
+                ++run_end;
+            }
+            const uint32_t instances_count = run_end - run_begin;
+
             // Bind Material uniform, if necessary
-            if (last_material_id != render_data.m_material_id)
+            if (last_material_id != draw_item.material_id)
             {
-                MaterialRenderData& material_render_data = m_cached_materials.Get(render_data.m_material_id);
+                MaterialRenderData& material_render_data = m_cached_materials.Get(draw_item.material_id);
                 m_render_device->Bind_DescriptorSet(m_graphics_pipeline, material_render_data.m_material_descriptor_sets[m_current_buffer], 2);
-                last_material_id = render_data.m_material_id;
+                last_material_id = draw_item.material_id;
             }
 
-            for (EntityID owner_node : render_data.m_owner_nodes)
+            // Bind surface buffers. Runs are sorted by surface, so each surface is bound once per material.
+            const SurfaceRenderData& render_data = m_cached_surfaces.Get(draw_item.surface_id);
+            assert(
+                render_data.m_vertex_buffer_handle.IsValid() && "Vertex buffer must be valid to bind to a command buffer.");
+            m_render_device->BindVertexBuffer(render_data.m_vertex_buffer_handle);
+            if (render_data.m_index_buffer_handle.IsValid())
             {
-                auto entity_iter = m_entities_map.find(owner_node);
-                if (entity_iter == m_entities_map.end())
-                {
-                    BRR_LogError(
-                        "Surface (ID: {}) is owned by non-existing Entity (ID: {}).\nSkipping rendering of this Entity.",
-                        uint64_t(render_data.m_surface_id), uint32_t(owner_node));
-                    continue;
-                }
-                EntityInfo& entity_info = entity_iter->second;
-
-                // Entity uniform (model matrix)
-                m_render_device->Bind_DescriptorSet(m_graphics_pipeline, entity_info.descriptor_sets[m_current_buffer], 3);
-
-                assert(
-                    render_data.m_vertex_buffer_handle.IsValid() && "Vertex buffer must be valid to bind to a command buffer.");
-                m_render_device->BindVertexBuffer(render_data.m_vertex_buffer_handle);
-
-                if (render_data.m_index_buffer_handle.IsValid())
-                {
-                    m_render_device->BindIndexBuffer(render_data.m_index_buffer_handle);
-                    m_render_device->DrawIndexed(render_data.m_num_indices, 1, 0, 0, 0);
-                }
-                else
-                {
-                    m_render_device->Draw(render_data.m_num_vertices, 1, 0, 0);
-                }
+                m_render_device->BindIndexBuffer(render_data.m_index_buffer_handle);
+                m_render_device->DrawIndexed(render_data.m_num_indices, instances_count, 0, 0, run_begin);
+            }
+            else
+            {
+                m_render_device->Draw(render_data.m_num_vertices, instances_count, 0, run_begin);
             }
+            ++viewport.culling_stats.draw_calls;
         }
 
         m_render_device->RenderTarget_EndRendering(viewport.color_attachment[m_current_buffer]);
@@ -799,6 +913,21 @@ namespace brr::render
             setBuilder.UpdateDescriptorSet(viewport.camera_descriptor_sets[frame_idx]);
         }
 
+        // Init viewport instance buffers and descriptor sets
+        descriptors_handles = m_render_device->DescriptorSet_Allocate(shader->GetDescriptorSetLayouts()[3].m_layout_handle,
+                                                                      FRAME_LAG);
+        std::ranges::copy(descriptors_handles, viewport.instance_descriptor_sets.begin());
+
+        for (uint32_t frame_idx = 0; frame_idx < FRAME_LAG; frame_idx++)
+        {
+            viewport.instance_buffers[frame_idx] = DeviceBuffer(min_instance_buffer_capacity * sizeof(uint32_t),
+                                                                BufferUsage::StorageBuffer | BufferUsage::HostAccessSequencial,
+                                                                MemoryUsage::AUTO);
+            viewport.instance_buffers_capacity[frame_idx] = min_instance_buffer_capacity;
+
+            UpdateViewportInstanceDescriptor(viewport, frame_idx);
+        }
+
         CameraUniform camera_uniform;
         glm::vec3 camera_position;
         if (m_cameras.Contains(viewport.camera_id))
@@ -808,10 +937,10 @@ namespace brr::render
             glm::mat4 projection_matrix = glm::perspective(camera_info.camera_fov_y, aspect, camera_info.camera_near,
                                                            camera_info.camera_far);
 
-            EntityInfo& entity    = m_entities_map[camera_info.owner_entity];
-            glm::mat4 view_matrix = glm::inverse(entity.current_matrix);
+            const glm::mat4& owner_transform = GetEntityTransform(camera_info.owner_entity);
+            glm::mat4 view_matrix = glm::inverse(owner_transform);
             camera_uniform.projection_view = projection_matrix * view_matrix;
-            camera_position                = entity.current_matrix[3];
+            camera_position                = owner_transform[3];
         }
         else
         {
@@ -821,6 +950,7 @@ namespace brr::render
             camera_uniform.projection_view = glm::identity<glm::mat4>();
             viewport.camera_id = CameraID::NULL_ID;
         }
+        viewport.frustum = Frustum::FromProjectionView(camera_uniform.projection_view);
 
         for (uint32_t frame_idx = 0; frame_idx < FRAME_LAG; frame_idx++)
         {
@@ -834,54 +964,136 @@ namespace brr::render
         BRR_LogInfo("Initialized Viewport Uniform Buffers.");
     }
 
-    void SceneRenderer::SetupEntityUniforms(EntityInfo& entity_info)
+    void SceneRenderer::SetupObjectBuffers()
     {
-        size_t buffer_size = sizeof(glm::mat4);
-
         for (uint32_t frame_idx = 0; frame_idx < FRAME_LAG; frame_idx++)
         {
-            entity_info.uniform_buffers[frame_idx] = DeviceBuffer(buffer_size,
-                                                                  UniformBuffer | HostAccessSequencial,
-                                                                  MemoryUsage::AUTO);
-            entity_info.uniform_buffers[frame_idx].Map();
-            entity_info.uniform_buffers[frame_idx].WriteToBuffer(&entity_info.current_matrix);
-            entity_info.uniform_buffers[frame_idx].Unmap();
+            DeviceBuffer& object_buffer = m_object_buffer_info.m_object_buffers[frame_idx];
+            object_buffer = DeviceBuffer(min_object_buffer_capacity * sizeof(ObjectData),
+                                         BufferUsage::StorageBuffer | BufferUsage::HostAccessSequencial,
+                                         MemoryUsage::AUTO);
+            // Kept mapped until the buffer is destroyed.
+            m_object_buffer_info.m_mapped_objects[frame_idx] = static_cast<ObjectData*>(object_buffer.Map());
+            m_object_buffer_info.m_capacity[frame_idx]       = min_object_buffer_capacity;
+            assert(m_object_buffer_info.m_mapped_objects[frame_idx] && "Could not map the SceneRenderer object buffer.");
+        }
+        BRR_LogInfo("Initialized Object Buffers.");
+    }
+
+    void SceneRenderer::ReserveObjectBuffer(uint32_t objects_count)
+    {
+        uint32_t& capacity = m_object_buffer_info.m_capacity[m_current_buffer];
+        if (objects_count <= capacity)
+        {
+            return;
+        }
+        while (capacity < objects_count)
+        {
+            capacity *= 2;
+        }
+
+        // The buffer of this frame is not in use by the GPU anymore, so it can be replaced.
+        DeviceBuffer& object_buffer = m_object_buffer_info.m_object_buffers[m_current_buffer];
+        object_buffer = DeviceBuffer(capacity * sizeof(ObjectData),
+                                     BufferUsage::StorageBuffer | BufferUsage::HostAccessSequencial,
+                                     MemoryUsage::AUTO);
+        ObjectData* mapped_objects = static_cast<ObjectData*>(object_buffer.Map());
+        assert(mapped_objects && "Could not map the SceneRenderer object buffer.");
+        m_object_buffer_info.m_mapped_objects[m_current_buffer] = mapped_objects;
+        ++m_object_buffer_info.m_versions[m_current_buffer];
+
+        for (uint32_t entity_slot = 0; entity_slot < m_entities.Size(); ++entity_slot)
+        {
+            mapped_objects[entity_slot].model_matrix = m_entities.transforms[entity_slot];
+        }
+        BRR_LogInfo("Resized Object Buffer of frame {}. New capacity: {} objects.", m_current_buffer, capacity);
+    }
 
+    void SceneRenderer::WriteViewportInstances(Viewport& viewport, std::span<const uint32_t> object_indices)
+    {
+        const uint32_t instances_count = static_cast<uint32_t>(object_indices.size());
+        uint32_t& capacity = viewport.instance_buffers_capacity[m_current_buffer];
+        DeviceBuffer& instance_buffer = viewport.instance_buffers[m_current_buffer];
+        if (instances_count > capacity)
+        {
+            // The buffer of this frame is not in use by the GPU anymore, so it can be replaced.
+            while (capacity < instances_count)
+            {
+                capacity *= 2;
+            }
+            instance_buffer = DeviceBuffer(capacity * sizeof(uint32_t),
+                                           BufferUsage::StorageBuffer | BufferUsage::HostAccessSequencial,
+                                           MemoryUsage::AUTO);
+            UpdateViewportInstanceDescriptor(viewport, m_current_buffer);
+        }
+        else if (viewport.object_buffer_versions[m_current_buffer] != m_object_buffer_info.m_versions[m_current_buffer])
+        {
+            UpdateViewportInstanceDescriptor(viewport, m_current_buffer);
         }
 
+        if (instances_count == 0)
+        {
+            return;
+        }
+        instance_buffer.Map();
+        instance_buffer.WriteToBuffer((void*)object_indices.data(), instances_count * sizeof(uint32_t));
+        instance_buffer.Unmap();
+    }
+
+    void SceneRenderer::UpdateViewportInstanceDescriptor(Viewport& viewport, uint32_t frame_idx)
+    {
         Shader* shader = RenderStorageGlobals::material_storage.GetShader(m_shader_id);
         assert(shader != nullptr && "Default shader must be initialized when updating SceneRenderer.");
 
-        // Init model descriptor sets
-        entity_info.descriptor_layout = shader->GetDescriptorSetLayouts()[3];
+        auto setBuilder = DescriptorSetUpdater(shader->GetDescriptorSetLayouts()[3]);
+        setBuilder.BindBuffer(0, m_object_buffer_info.m_object_buffers[frame_idx].GetHandle(),
+                              m_object_buffer_info.m_capacity[frame_idx] * sizeof(ObjectData));
+        setBuilder.BindBuffer(1, viewport.instance_buffers[frame_idx].GetHandle(),
+                              viewport.instance_buffers_capacity[frame_idx] * sizeof(uint32_t));
 
-        std::vector<DescriptorSetHandle> descriptors_handles = m_render_device->
-            DescriptorSet_Allocate(entity_info.descriptor_layout.m_layout_handle,
-                                   FRAME_LAG);
-        std::ranges::copy(descriptors_handles, entity_info.descriptor_sets.begin());
+        setBuilder.UpdateDescriptorSet(viewport.instance_descriptor_sets[frame_idx]);
+        viewport.object_buffer_versions[frame_idx] = m_object_buffer_info.m_versions[frame_idx];
+    }
 
-        for (uint32_t frame_idx = 0; frame_idx < FRAME_LAG; frame_idx++)
-        {
-            auto setBuilder = DescriptorSetUpdater(entity_info.descriptor_layout);
-            setBuilder.BindBuffer(0, entity_info.uniform_buffers[frame_idx].GetHandle(), buffer_size);
+    void SceneRenderer::MarkEntityDirty(uint32_t entity_slot, bool mark_surface, bool mark_uniform)
+    {
+        uint8_t& dirty_flags = m_entities.dirty_flags[entity_slot];
+        // Surfaces that changed or were removed can shrink the bounds, which are rebuilt on the next update.
+        if (mark_surface) dirty_flags |= internal::EntityRenderStorage::SURFACES_DIRTY_BIT;
+        // Mark the transforms of all frame buffers as dirty.
+        if (mark_uniform) dirty_flags |= internal::EntityRenderStorage::TRANSFORM_DIRTY_MASK;
+    }
 
-            setBuilder.UpdateDescriptorSet(entity_info.descriptor_sets[frame_idx]);
+    void SceneRenderer::UpdateEntityBounds(uint32_t entity_slot)
+    {
+        AABBB local_bounds;
+        for (SurfaceID surface_id : m_entities.GetSurfaces(entity_slot))
+        {
+            if (m_cached_surfaces.Contains(surface_id))
+            {
+                local_bounds.Expand(m_cached_surfaces.Get(surface_id).m_bounds);
+            }
         }
-        BRR_LogInfo("Initialized Entity Uniform Buffers.");
+        m_entities.local_bounds[entity_slot] = local_bounds;
+        SetEntityWorldBounds(entity_slot, local_bounds.Transformed(m_entities.transforms[entity_slot]));
     }
 
-    void SceneRenderer::MarkEntityDirty(EntityID entity_id, EntityInfo& entity_info, bool mark_surface, bool mark_uniform)
+    void SceneRenderer::SetEntityWorldBounds(uint32_t entity_slot, const AABBB& world_bounds)
     {
-        if (mark_surface) entity_info.surfaces_dirty = true; // TODO: Rethink if necessary. Maybe surfaces AABB update can be done when entity is updated.
-        if (mark_uniform)
-        {
-            // If entity was not already dirty, add it to dirty entities list.
-            if (!std::ranges::any_of(entity_info.transform_dirty, [](bool dirty) { return dirty; }))
-                m_dirty_entities.push_back(entity_id);
+        m_entities.bounds[entity_slot]       = world_bounds;
+        m_entities.dirty_flags[entity_slot] |= internal::EntityRenderStorage::BOUNDS_DIRTY_BIT;
+    }
+
+    const glm::mat4& SceneRenderer::GetEntityTransform(EntityID entity_id) const
+    {
+        static const glm::mat4 identity_transform = glm::identity<glm::mat4>();
 
-            // Mark all transforms as dirty.
-            entity_info.transform_dirty.fill(true);
+        const uint32_t entity_slot = m_entities.GetSlot(entity_id);
+        if (entity_slot == internal::EntityRenderStorage::INVALID_SLOT)
+        {
+            return identity_transform;
         }
+        return m_entities.transforms[entity_slot];
     }
 
     bool SceneRenderer::CreateNewLight(LightID light_id,
@@ -895,25 +1107,26 @@ namespace brr::render
             return false;
         }
 
-        auto entity_it = m_entities_map.find(owner_entity);
-        if (entity_it == m_entities_map.end())
+        const uint32_t entity_slot = m_entities.GetSlot(owner_entity);
+        if (entity_slot == internal::EntityRenderStorage::INVALID_SLOT)
         {
             BRR_LogError("Can't create Light (ID: {}) to SceneRenderer Entity (ID: {}) because this entity doesn't exist.",
                          static_cast<uint64_t>(light_id), static_cast<uint32_t>(owner_entity));
             return false;
         }
 
-        EntityInfo& entity_info = entity_it->second;
-        if (entity_info.attached_light != LightID::NULL_ID)
+        LightID& attached_light = m_entities.attached_lights[entity_slot];
+        if (attached_light != LightID::NULL_ID)
         {
             BRR_LogError("Can't create Light (ID: {}) to SceneRenderer Entity (ID: {}) because this entity already has a light attached (Light ID: {}).",
                          static_cast<uint64_t>(light_id), static_cast<uint32_t>(owner_entity),
-                         static_cast<uint32_t>(entity_info.attached_light));
+                         static_cast<uint32_t>(attached_light));
             return false;
         }
 
-        const glm::vec3 light_location = glm::vec3(entity_info.current_matrix[3]);
-        const glm::vec3 light_direction = glm::vec3(entity_info.current_matrix[2]);
+        const glm::mat4& entity_transform = m_entities.transforms[entity_slot];
+        const glm::vec3 light_location = glm::vec3(entity_transform[3]);
+        const glm::vec3 light_direction = glm::vec3(entity_transform[2]);
 
         // Update light position and direction based on entity transform.
         new_light.light_position = light_location;
@@ -923,13 +1136,11 @@ namespace brr::render
         {
             BRR_LogError("Error creating new Light (ID: {}) to SceneRenderer. Failed to allocate Light rendering structure.",
                          static_cast<uint64_t>(light_id));
-            m_light_owners.erase(light_id);
-            entity_info.attached_light = LightID::NULL_ID;
             return false;
         }
 
-        m_light_owners[light_id] = owner_entity;
-        entity_info.attached_light = light_id;
+        m_light_owners.AddObject(light_id, owner_entity);
+        attached_light = light_id;
 
         m_scene_uniform_info.m_light_storage_dirty.fill(true);
         m_scene_uniform_info.m_light_storage_size_changed.fill(true);
@@ -1,12 +1,15 @@
 #ifndef BRR_SCENERENDERER_H
 #define BRR_SCENERENDERER_H
-#include <map>
 #include <Core/Ref.h>
 #include <Core/Storage/ContiguousPool.h>
+#include <Geometry/Frustum.h>
 #include <Renderer/GpuResources/Descriptors.h>
 #include <Renderer/GpuResources/DeviceBuffer.h>
+#include <Renderer/Internal/EntityBVH.h>
+#include <Renderer/Internal/EntityRenderStorage.h>
 #include <Renderer/RenderDefs.h>
 #include <Renderer/SceneObjectsIDs.h>
+#include <Renderer/TransformChannel.h>
 #include <Visualization/Resources/Image.h>
 
 #include "Storages/MeshStorage.h"
@@ -16,7 +19,16 @@ namespace brr::render
     class SceneRenderer
     {
     public:
-        SceneRenderer();
+        struct CullingStats
+        {
+            // Entity surfaces drawn and skipped by frustum culling on the last render of a viewport.
+            uint32_t drawn_objects  = 0;
+            uint32_t culled_objects = 0;
+            // Draw calls recorded on the last render of a viewport. Entities sharing a surface are drawn as instances.
+            uint32_t draw_calls     = 0;
+        };
+
+        explicit SceneRenderer(std::unique_ptr<TransformChannel> transform_channel);
 
         ~SceneRenderer();
 
@@ -42,8 +54,14 @@ namespace brr::render
         void CreateEntity(EntityID entity_id,
                           const glm::mat4& entity_transform = {});
         void DestroyEntity(EntityID entity_id);
-        void UpdateEntityTransform(EntityID entity_id,
-                                   const glm::mat4& entity_transform);
+        // Destroy the entities in bulk. Shared surfaces are updated once, however many of their owners are destroyed.
+        void DestroyEntities(std::span<const EntityID> entity_ids);
+
+        /**
+         * \brief Apply the entity transforms written in the published buffer 'transform_buffer_index' of the
+         *        transform channel. Transforms of entities that don't exist anymore are ignored.
+         */
+        void UpdateEntityTransforms(uint32_t transform_buffer_index);
 
         //-------------------------//
         //--- Surface Functions ---//
@@ -100,6 +118,8 @@ namespace brr::render
 
         void SetViewportCameraID(ViewportID viewport_id, CameraID camera_id);
 
+        CullingStats GetViewportCullingStats(ViewportID viewport_id) const;
+
         //-------------------------//
         //-- Rendering Functions --//
         //-------------------------//
@@ -112,14 +132,46 @@ namespace brr::render
     private:
         struct Viewport;
         struct Light;
-        struct EntityInfo;
         struct SurfaceRenderData;
 
         void SetupSceneUniforms();
         void SetupViewportUniforms(Viewport& viewport);
-        void SetupEntityUniforms(EntityInfo& entity_info);
-
-        void MarkEntityDirty(EntityID entity_id, EntityInfo& entity_info, bool mark_surface, bool mark_uniform);
+        void SetupObjectBuffers();
+
+        /**
+         * \brief Grow the object buffer of the current frame to hold 'objects_count' objects. A new buffer is filled
+         *        with the data of every entity.
+         */
+        void ReserveObjectBuffer(uint32_t objects_count);
+
+        /**
+         * \brief Write 'object_indices' to the instance buffer of the current frame of the viewport, growing it if it
+         *        is too small.
+         */
+        void WriteViewportInstances(Viewport& viewport, std::span<const uint32_t> object_indices);
+
+        /**
+         * \brief Bind the object buffer and the instance buffer of the frame 'frame_idx' to the viewport instance
+         *        descriptor set.
+         */
+        void UpdateViewportInstanceDescriptor(Viewport& viewport, uint32_t frame_idx);
+
+        void MarkEntityDirty(uint32_t entity_slot, bool mark_surface, bool mark_uniform);
+
+        /**
+         * \brief Rebuild the local bounds of the entity from its surfaces, and update its world bounds.
+         */
+        void UpdateEntityBounds(uint32_t entity_slot);
+
+        /**
+         * \brief Set the world bounds of the entity. The BVH is updated on the next 'UpdateDirtyInstances'.
+         */
+        void SetEntityWorldBounds(uint32_t entity_slot, const AABBB& world_bounds);
+
+        /**
+         * \brief Get the transform of the entity, or the identity matrix if the entity doesn't exist.
+         */
+        const glm::mat4& GetEntityTransform(EntityID entity_id) const;
 
         bool CreateNewLight(LightID light_id,
                             EntityID owner_entity,
@@ -141,6 +193,17 @@ namespace brr::render
             std::array<DeviceBuffer, FRAME_LAG> camera_uniform_buffers;
             std::array<DescriptorSetHandle, FRAME_LAG> camera_descriptor_sets;
             std::array<bool, FRAME_LAG> camera_uniform_dirty{true};
+
+            // Object indices of the instances drawn in the viewport, in draw order.
+            std::array<DeviceBuffer, FRAME_LAG> instance_buffers;
+            std::array<DescriptorSetHandle, FRAME_LAG> instance_descriptor_sets;
+            std::array<uint32_t, FRAME_LAG> instance_buffers_capacity{};
+            // Version of the object buffer bound to each instance descriptor set.
+            std::array<uint32_t, FRAME_LAG> object_buffer_versions{};
+
+            // Frustum of the last camera matrix written to the uniforms.
+            Frustum frustum;
+            CullingStats culling_stats;
         };
 
         struct CameraInfo
@@ -162,22 +225,6 @@ namespace brr::render
             glm::f32 light_cutoff{0.0};
         };
 
-        struct EntityInfo
-        {
-            glm::mat4 current_matrix;
-
-            // model matrix uniforms
-            DescriptorLayout descriptor_layout;
-            std::array<DeviceBuffer, FRAME_LAG> uniform_buffers;
-            std::array<DescriptorSetHandle, FRAME_LAG> descriptor_sets;
-            std::array<bool, FRAME_LAG> transform_dirty{false};
-
-            std::vector<SurfaceID> surfaces;
-            bool surfaces_dirty = false;
-
-            LightID attached_light = LightID::NULL_ID;
-        };
-
         struct SurfaceRenderData
         {
             SurfaceRenderData()
@@ -196,6 +243,7 @@ namespace brr::render
             IndexBufferHandle m_index_buffer_handle{};
 
             uint32_t m_num_vertices = 0, m_num_indices = 0;
+            AABBB m_bounds;
 
             MaterialID m_material_id;
             bool m_surface_dirty = false;
@@ -208,6 +256,12 @@ namespace brr::render
             size_t reference_count = 0;
         };
 
+        // Data of an entity read by the shaders. Must match 'ObjectData' in shader.vert.
+        struct ObjectData
+        {
+            glm::mat4 model_matrix;
+        };
+
         struct SceneUniformInfo
         {
             std::array<DeviceBuffer, FRAME_LAG> m_lights_buffers;
@@ -216,23 +270,47 @@ namespace brr::render
             std::array<bool, FRAME_LAG> m_light_storage_size_changed{true};
         } m_scene_uniform_info;
 
+        // Object data of every entity, indexed by entity slot. One buffer per frame, persistently mapped.
+        struct ObjectBufferInfo
+        {
+            std::array<DeviceBuffer, FRAME_LAG> m_object_buffers;
+            std::array<ObjectData*, FRAME_LAG> m_mapped_objects{};
+            std::array<uint32_t, FRAME_LAG> m_capacity{};
+            // Incremented when the buffer of a frame is recreated, so the viewports bind the new buffer.
+            std::array<uint32_t, FRAME_LAG> m_versions{};
+        } m_object_buffer_info;
+
         // Viewports
-        ContiguousPool<ViewportID, Viewport> m_viewports;
+        ContiguousPool<ViewportID, Viewport, RenderIdIndex> m_viewports;
 
         // Cameras
-        ContiguousPool<CameraID, CameraInfo> m_cameras;
+        ContiguousPool<CameraID, CameraInfo, RenderIdIndex> m_cameras;
 
         // Lights
-        ContiguousPool<LightID, Light> m_scene_lights;
-        std::unordered_map<LightID, EntityID> m_light_owners;
+        // 'm_light_owners' is kept apart from 'm_scene_lights', since the Light array is uploaded as is to the lights buffer.
+        ContiguousPool<LightID, Light, RenderIdIndex> m_scene_lights;
+        ContiguousPool<LightID, EntityID, RenderIdIndex> m_light_owners;
 
         // Surfaces and Materials
-        ContiguousPool<SurfaceID, SurfaceRenderData, std::hash<ResourceHandle>> m_cached_surfaces;
-        ContiguousPool<MaterialID, MaterialRenderData, std::hash<ResourceHandle>> m_cached_materials;
+        ContiguousPool<SurfaceID, SurfaceRenderData, ResourceHandleIndex> m_cached_surfaces;
+        ContiguousPool<MaterialID, MaterialRenderData, ResourceHandleIndex> m_cached_materials;
 
         // Entities
-        std::vector<EntityID> m_dirty_entities{};
-        std::map<EntityID, EntityInfo> m_entities_map{};
+        internal::EntityRenderStorage m_entities{};
+        std::unique_ptr<TransformChannel> m_transform_channel;
+        // Entities with surfaces, by world bounds.
+        internal::EntityBVH m_entity_bvh;
+
+        // Surfaces of the entities visible in the viewport being rendered.
+        struct DrawItem
+        {
+            MaterialID material_id;
+            SurfaceID surface_id;
+            uint32_t entity_slot;
+        };
+        std::vector<DrawItem> m_draw_items;
+        // Object indices of the draw items, in the order they are drawn.
+        std::vector<uint32_t> m_instance_object_indices;
 
         // Resources
         Ref<vis::Image> m_image;
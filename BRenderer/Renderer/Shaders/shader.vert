@@ -27,17 +27,30 @@ layout(set = 1, binding = 0) uniform CameraUBO
     mat4 projection_view;
 } camera_ubo;
 
-layout(set = 3, binding = 0) uniform ModelUBO
+struct ObjectData
 {
     mat4 model;
-} model_ubo;
+};
+
+// Data of every object of the scene.
+layout(std430, set = 3, binding = 0) readonly buffer ObjectBuffer
+{
+    ObjectData objects[];
+} object_buffer;
+
+// Object index of the instances drawn by the viewport, indexed by gl_InstanceIndex.
+layout(std430, set = 3, binding = 1) readonly buffer InstanceBuffer
+{
+    uint object_indices[];
+} instance_buffer;
 
 void main()
 {
-    gl_Position = camera_ubo.projection_view * model_ubo.model * vec4(inPosition, 1.0);
-    outPosition = vec3(model_ubo.model * vec4(inPosition, 1.0));
-    outNormal = vec3(model_ubo.model * vec4(normal, 0.0));
-    outTangent = vec3(model_ubo.model * vec4(tangent, 0.0));
+    mat4 model = object_buffer.objects[instance_buffer.object_indices[gl_InstanceIndex]].model;
+    gl_Position = camera_ubo.projection_view * model * vec4(inPosition, 1.0);
+    outPosition = vec3(model * vec4(inPosition, 1.0));
+    outNormal = vec3(model * vec4(normal, 0.0));
+    outTangent = vec3(model * vec4(tangent, 0.0));
     outBitangent = cross(outNormal, outTangent);
     uvCoord = vec2 (u_texcoord, v_texcoord);
 }
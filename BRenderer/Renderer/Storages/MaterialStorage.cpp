@@ -88,8 +88,9 @@ ShaderID MaterialStorage::CreateShader(const std::string& shader_name,
         .AddSet() // Set 2 -> Binding 0: Material transform.
         .AddSetBinding(DescriptorType::UniformBuffer, FragmentShader)
         .AddSetBinding(DescriptorType::CombinedImageSampler, FragmentShader)
-        .AddSet() // Set 3 -> Binding 0: Model Uniform
-        .AddSetBinding(DescriptorType::UniformBuffer, VertexShader);
+        .AddSet() // Set 3 -> Binding 0: Objects data, Binding 1: Instances object indices
+        .AddSetBinding(DescriptorType::StorageBuffer, VertexShader)
+        .AddSetBinding(DescriptorType::StorageBuffer, VertexShader);
 
     Shader* shader_ptr;
     ResourceHandle shader_handle = m_shader_storage.CreateResource(&shader_ptr, shader_builder.BuildShader());
@@ -1,5 +1,6 @@
 #include "MeshStorage.h"
 
+#include <Geometry/BoundsKernels.h>
 #include <Renderer/SceneObjectsIDs.h>
 #include <Renderer/Vulkan/VulkanRenderDevice.h>
 
@@ -62,6 +63,7 @@ void MeshStorage::InitSurface(SurfaceID surface_id,
         vertex_buffer_size, vertex_format, vertex_buffer_data);
 
     surface->num_vertices = vertex_buffer_size / sizeof(Vertex3);
+    surface->m_aabb       = ComputeVerticesBounds(static_cast<const Vertex3*>(vertex_buffer_data), surface->num_vertices);
 
     if (!index_buffer_data || index_buffer_size == 0)
             return;
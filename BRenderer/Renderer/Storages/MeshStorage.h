@@ -16,6 +16,7 @@ namespace brr::render
 
         uint32_t num_vertices = 0, num_indices = 0;
 
+        // Bounds of the vertices positions, in local space.
         AABBB m_aabb;
 
         MaterialID m_material_id = MaterialID();
@@ -0,0 +1,54 @@
+#include "TransformChannel.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace brr::render
+{
+    void TransformChannel::Write(EntityID entity_id, const glm::mat4& transform)
+    {
+        assert(entity_id != EntityID::NULL_ID && "Can't write the transform of the NULL_ID entity.");
+
+        Buffer& buffer = m_buffers[m_write_buffer];
+        const uint32_t entity_index = GetRenderIdIndex(entity_id);
+        if (entity_index >= buffer.transforms.size())
+        {
+            const size_t new_size = std::max<size_t>(entity_index + 1, buffer.transforms.size() * 2);
+            buffer.transforms.resize(new_size);
+            buffer.entity_ids.resize(new_size, EntityID::NULL_ID);
+            buffer.dirty_words.resize((new_size + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+        }
+
+        const uint32_t word_index = entity_index / BITS_PER_WORD;
+        buffer.transforms[entity_index] = transform;
+        buffer.entity_ids[entity_index] = entity_id;
+        buffer.dirty_words[word_index] |= uint64_t(1) << (entity_index % BITS_PER_WORD);
+        buffer.first_dirty_word = std::min(buffer.first_dirty_word, word_index);
+        buffer.last_dirty_word  = std::max(buffer.last_dirty_word, word_index);
+    }
+
+    void TransformChannel::Discard(EntityID entity_id)
+    {
+        Buffer& buffer = m_buffers[m_write_buffer];
+        const uint32_t entity_index = GetRenderIdIndex(entity_id);
+        if (entity_index < buffer.transforms.size())
+        {
+            const uint32_t word_index = entity_index / BITS_PER_WORD;
+            buffer.dirty_words[word_index] &= ~(uint64_t(1) << (entity_index % BITS_PER_WORD));
+            // Keep the range tight, so 'HasPendingWrites' is false once every write is discarded.
+            if (buffer.dirty_words[word_index] == 0
+                && (word_index == buffer.first_dirty_word || word_index == buffer.last_dirty_word))
+            {
+                buffer.ShrinkDirtyRange();
+            }
+        }
+    }
+
+    uint32_t TransformChannel::Publish()
+    {
+        const uint32_t published_buffer = m_write_buffer;
+        m_write_buffer = (m_write_buffer + 1) % BUFFER_COUNT;
+        assert(!m_buffers[m_write_buffer].HasDirtyEntries() && "Next write buffer was not consumed by the render thread.");
+        return published_buffer;
+    }
+}
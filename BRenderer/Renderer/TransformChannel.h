@@ -0,0 +1,157 @@
+#ifndef BRR_TRANSFORMCHANNEL_H
+#define BRR_TRANSFORMCHANNEL_H
+
+#include <Core/thirdpartiesInc.h>
+#include <Renderer/RenderDefs.h>
+#include <Renderer/SceneObjectsIDs.h>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace brr::render
+{
+    /**
+     * \brief Channel used to send entity world matrices from the main thread to a SceneRenderer.
+     *
+     * Each buffer is a dense array of matrices indexed by the index of the EntityIDs, with a bitset marking the entries written since
+     * the buffer was published. The full EntityID of each entry is kept, so the render thread can tell a write to a
+     * destroyed entity from a write to the entity that reused its index. The main thread writes into the current write buffer, and `Publish` hands it to the
+     * render thread, which consumes the changed ranges in bulk.
+     *
+     * A published buffer is only reused for writing after `BUFFER_COUNT - 1` other buffers are published. Since the
+     * main thread can't run more than `FRAME_LAG - 1` frames ahead of the render thread, and buffers are consumed
+     * in the order of the update commands, the render thread is done with a buffer before it is written again.
+     */
+    class TransformChannel
+    {
+    public:
+        static constexpr uint32_t BUFFER_COUNT = FRAME_LAG + 1;
+
+        //-------------------//
+        //--- Main Thread ---//
+        //-------------------//
+
+        void Write(EntityID entity_id, const glm::mat4& transform);
+
+        /**
+         * \brief Discard the pending write of the entity, if any. Used when the entity is destroyed.
+         */
+        void Discard(EntityID entity_id);
+
+        [[nodiscard]] bool HasPendingWrites() const { return m_buffers[m_write_buffer].HasDirtyEntries(); }
+
+        /**
+         * \brief Publish the current write buffer and start writing into the next one.
+         * \return Index of the published buffer, which must be passed to `Consume` on the render thread.
+         */
+        uint32_t Publish();
+
+        //---------------------//
+        //--- Render Thread ---//
+        //---------------------//
+
+        /**
+         * \brief Call 'range_func(entity_ids, transforms)' for each contiguous range of entity indices written in the
+         *        published buffer, and reset the buffer's dirty bits.
+         * \param range_func Callable with signature 'void(std::span<const EntityID>, std::span<const glm::mat4>)'.
+         */
+        template <typename RangeFunc>
+        void Consume(uint32_t buffer_index, RangeFunc&& range_func);
+
+    private:
+        static constexpr uint32_t BITS_PER_WORD = 64;
+        static constexpr uint32_t NO_DIRTY_WORD = std::numeric_limits<uint32_t>::max();
+
+        struct Buffer
+        {
+            [[nodiscard]] bool HasDirtyEntries() const { return first_dirty_word <= last_dirty_word; }
+
+            /**
+             * \brief Move the bounds of the dirty range past the words without dirty bits, resetting it if no bit is left.
+             */
+            void ShrinkDirtyRange()
+            {
+                while (first_dirty_word <= last_dirty_word && dirty_words[first_dirty_word] == 0)
+                {
+                    first_dirty_word++;
+                }
+                while (first_dirty_word < last_dirty_word && dirty_words[last_dirty_word] == 0)
+                {
+                    last_dirty_word--;
+                }
+                if (first_dirty_word > last_dirty_word)
+                {
+                    ResetDirtyRange();
+                }
+            }
+
+            void ResetDirtyRange()
+            {
+                first_dirty_word = NO_DIRTY_WORD;
+                last_dirty_word  = 0;
+            }
+
+            std::vector<glm::mat4> transforms;
+            // ID that wrote each entry.
+            std::vector<EntityID> entity_ids;
+            std::vector<uint64_t> dirty_words;
+            // Range of words that may have dirty bits, so sparse updates don't scan the whole bitset.
+            uint32_t first_dirty_word = NO_DIRTY_WORD;
+            uint32_t last_dirty_word  = 0;
+        };
+
+        std::array<Buffer, BUFFER_COUNT> m_buffers;
+        uint32_t m_write_buffer = 0;
+    };
+
+    template <typename RangeFunc>
+    void TransformChannel::Consume(uint32_t buffer_index, RangeFunc&& range_func)
+    {
+        Buffer& buffer = m_buffers[buffer_index];
+        if (!buffer.HasDirtyEntries())
+        {
+            return;
+        }
+
+        // Runs of set bits are merged across word boundaries, so each range is reported only once.
+        uint32_t range_begin = 0;
+        uint32_t range_end   = 0;
+        for (uint32_t word_index = buffer.first_dirty_word; word_index <= buffer.last_dirty_word; word_index++)
+        {
+            uint64_t word = buffer.dirty_words[word_index];
+            buffer.dirty_words[word_index] = 0;
+
+            const uint32_t word_base = word_index * BITS_PER_WORD;
+            while (word != 0)
+            {
+                const uint32_t run_begin = static_cast<uint32_t>(std::countr_zero(word));
+                const uint32_t run_size  = static_cast<uint32_t>(std::countr_one(word >> run_begin));
+                if (range_end != word_base + run_begin)
+                {
+                    if (range_end != range_begin)
+                    {
+                        range_func(std::span<const EntityID>(buffer.entity_ids.data() + range_begin, range_end - range_begin),
+                                   std::span<const glm::mat4>(buffer.transforms.data() + range_begin, range_end - range_begin));
+                    }
+                    range_begin = word_base + run_begin;
+                }
+                range_end = word_base + run_begin + run_size;
+
+                word = run_begin + run_size < BITS_PER_WORD ? word & (~uint64_t(0) << (run_begin + run_size)) : 0;
+            }
+        }
+        if (range_end != range_begin)
+        {
+            range_func(std::span<const EntityID>(buffer.entity_ids.data() + range_begin, range_end - range_begin),
+                       std::span<const glm::mat4>(buffer.transforms.data() + range_begin, range_end - range_begin));
+        }
+
+        buffer.ResetDirtyRange();
+    }
+}
+
+#endif
@@ -510,7 +510,7 @@ namespace brr::render
         };
 
         vk::DescriptorPool m_imgui_desc_pool {};
-        ContiguousPool<Texture2DHandle, ImGuiTextureData, std::hash<ResourceHandle>> m_imgui_texture_pool{};
+        ContiguousPool<Texture2DHandle, ImGuiTextureData, ResourceHandleIndex> m_imgui_texture_pool{};
     };
 
     inline VulkanRenderDevice::VertexFormatFlags operator|(VulkanRenderDevice::VertexFormatFlags a, VulkanRenderDevice::VertexFormatFlags b)
@@ -33,6 +33,7 @@ namespace brr
 
         void RegisterGraphics() {}
         void UnregisterGraphics() {}
+        void UpdateGraphics() {}
 
     private:
         friend class Entity;
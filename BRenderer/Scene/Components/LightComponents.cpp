@@ -39,10 +39,7 @@ namespace brr
         if (m_intensity != intensity)
         {
             m_intensity = intensity;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
-            }
+            GetEntity().MarkComponentChanged<PointLightComponent>();
         }
     }
 
@@ -51,10 +48,7 @@ namespace brr
         if (m_color != color)
         {
             m_color = color;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
-            }
+            GetEntity().MarkComponentChanged<PointLightComponent>();
         }
     }
 
@@ -74,6 +68,13 @@ namespace brr
         m_light_id = render::LightID::NULL_ID;
     }
 
+    void PointLightComponent::UpdateGraphics()
+    {
+        vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy();
+        assert(scene_renderer && "Can't call 'PointLightComponent::UpdateGraphics' when SceneRenderer is NULL.");
+        scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
+    }
+
     DirectionalLightComponent::DirectionalLightComponent(const glm::vec3& color,
                                                          float intensity) noexcept
     : m_intensity(intensity), m_color(color)
@@ -109,10 +110,7 @@ namespace brr
         if (m_intensity != intensity)
         {
             m_intensity = intensity;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
-            }
+            GetEntity().MarkComponentChanged<DirectionalLightComponent>();
         }
     }
 
@@ -121,10 +119,7 @@ namespace brr
         if (m_color != color)
         {
             m_color = color;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
-            }
+            GetEntity().MarkComponentChanged<DirectionalLightComponent>();
         }
     }
 
@@ -144,6 +139,13 @@ namespace brr
         m_light_id = render::LightID::NULL_ID;
     }
 
+    void DirectionalLightComponent::UpdateGraphics()
+    {
+        vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy();
+        assert(scene_renderer && "Can't call 'DirectionalLightComponent::UpdateGraphics' when SceneRenderer is NULL.");
+        scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
+    }
+
     SpotLightComponent::SpotLightComponent(const glm::vec3& color, float intensity, float cutoff_angle) noexcept
     : m_color(color), m_intensity(intensity), m_cutoff_angle(cutoff_angle)
     {
@@ -179,10 +181,7 @@ namespace brr
         if (m_cutoff_angle != cutoff_angle)
         {
             m_cutoff_angle = cutoff_angle;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, m_cutoff_angle);
-            }
+            GetEntity().MarkComponentChanged<SpotLightComponent>();
         }
     }
 
@@ -191,10 +190,7 @@ namespace brr
         if (m_intensity != intensity)
         {
             m_intensity = intensity;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, m_cutoff_angle);
-            }
+            GetEntity().MarkComponentChanged<SpotLightComponent>();
         }
     }
 
@@ -203,10 +199,7 @@ namespace brr
         if (m_color != color)
         {
             m_color = color;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, m_cutoff_angle);
-            }
+            GetEntity().MarkComponentChanged<SpotLightComponent>();
         }
     }
 
@@ -226,6 +219,13 @@ namespace brr
         m_light_id = render::LightID::NULL_ID;
     }
 
+    void SpotLightComponent::UpdateGraphics()
+    {
+        vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy();
+        assert(scene_renderer && "Can't call 'SpotLightComponent::UpdateGraphics' when SceneRenderer is NULL.");
+        scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, m_cutoff_angle);
+    }
+
     AmbientLightComponent::AmbientLightComponent(const glm::vec3& color, float intensity)
     : m_color(color), m_intensity(intensity)
     {
@@ -260,10 +260,7 @@ namespace brr
         if (m_color != color)
         {
             m_color = color;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
-            }
+            GetEntity().MarkComponentChanged<AmbientLightComponent>();
         }
     }
 
@@ -272,10 +269,7 @@ namespace brr
         if (m_intensity != intensity)
         {
             m_intensity = intensity;
-            if (vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy())
-            {
-                scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
-            }
+            GetEntity().MarkComponentChanged<AmbientLightComponent>();
         }
     }
 
@@ -294,4 +288,11 @@ namespace brr
         scene_renderer->DestroyLight(m_light_id);
         m_light_id = render::LightID::NULL_ID;
     }
+
+    void AmbientLightComponent::UpdateGraphics()
+    {
+        vis::SceneRenderProxy* scene_renderer = GetScene()->GetSceneRendererProxy();
+        assert(scene_renderer && "Can't call 'AmbientLightComponent::UpdateGraphics' when SceneRenderer is NULL.");
+        scene_renderer->UpdateLight(m_light_id, m_color, m_intensity, 0.0);
+    }
 }
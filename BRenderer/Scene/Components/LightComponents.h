@@ -26,8 +26,11 @@ namespace brr
 
 		void RegisterGraphics();
 		void UnregisterGraphics();
+		void UpdateGraphics();
 
 	private:
+        friend class Scene;
+
         glm::vec3 m_color;
         float m_intensity;
         render::LightID m_light_id = render::LightID::NULL_ID;
@@ -54,8 +57,11 @@ namespace brr
 
 		void RegisterGraphics();
 		void UnregisterGraphics();
+		void UpdateGraphics();
 
 	private:
+		friend class Scene;
+
 		glm::vec3 m_color;
 		float m_intensity;
 		render::LightID m_light_id = render::LightID::NULL_ID;
@@ -85,8 +91,11 @@ namespace brr
 
 		void RegisterGraphics();
 		void UnregisterGraphics();
+		void UpdateGraphics();
 
 	private:
+		friend class Scene;
+
 		glm::vec3 m_color;
 		float m_intensity;
 		float m_cutoff_angle;
@@ -114,8 +123,10 @@ namespace brr
 
 		void RegisterGraphics();
 		void UnregisterGraphics();
+		void UpdateGraphics();
 
 	private:
+		friend class Scene;
 
 		glm::vec3 m_color;
 		float m_intensity;
@@ -55,8 +55,7 @@ namespace brr
         if (m_fov_y != fov_y)
         {
             m_fov_y = fov_y;
-            vis::SceneRenderProxy* scene_render_proxy = GetScene()->GetSceneRendererProxy();
-            scene_render_proxy->UpdateCameraProjectionMatrix(m_camera_id, m_fov_y, m_near, m_far);
+            GetEntity().MarkComponentChanged<PerspectiveCameraComponent>();
         }
     }
 
@@ -65,8 +64,7 @@ namespace brr
         if (m_near != near)
         {
             m_near = near;
-            vis::SceneRenderProxy* scene_render_proxy = GetScene()->GetSceneRendererProxy();
-            scene_render_proxy->UpdateCameraProjectionMatrix(m_camera_id, m_fov_y, m_near, m_far);
+            GetEntity().MarkComponentChanged<PerspectiveCameraComponent>();
         }
     }
 
@@ -75,8 +73,7 @@ namespace brr
         if (m_far != far)
         {
             m_far = far;
-            vis::SceneRenderProxy* scene_render_proxy = GetScene()->GetSceneRendererProxy();
-            scene_render_proxy->UpdateCameraProjectionMatrix(m_camera_id, m_fov_y, m_near, m_far);
+            GetEntity().MarkComponentChanged<PerspectiveCameraComponent>();
         }
     }
 
@@ -111,4 +108,11 @@ namespace brr
 		scene_render_proxy->DestroyCamera(m_camera_id);
         m_camera_id = render::CameraID::NULL_ID;
     }
+
+    void PerspectiveCameraComponent::UpdateGraphics()
+    {
+        vis::SceneRenderProxy* scene_render_proxy = GetScene()->GetSceneRendererProxy();
+        assert(scene_render_proxy && "Can't call 'PerspectiveCameraComponent::UpdateGraphics' when SceneRenderer is NULL.");
+        scene_render_proxy->UpdateCameraProjectionMatrix(m_camera_id, m_fov_y, m_near, m_far);
+    }
 }
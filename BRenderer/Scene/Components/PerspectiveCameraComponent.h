@@ -96,8 +96,10 @@ namespace brr
 
         void RegisterGraphics();
 		void UnregisterGraphics();
+        void UpdateGraphics();
 
 	private:
+		friend class Scene;
 
 		float m_fov_y;
 		float m_near;
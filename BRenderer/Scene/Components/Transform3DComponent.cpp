@@ -15,6 +15,11 @@ namespace brr
     {
     }
 
+    void Transform3DComponent::OnInit()
+    {
+        m_hierarchy_index = GetTransformStorage().Add();
+    }
+
     void Transform3DComponent::RegisterGraphics()
     {
         vis::SceneRenderProxy* scene_renderer_proxy = GetScene()->GetSceneRendererProxy();
@@ -32,59 +37,79 @@ namespace brr
 
     void Transform3DComponent::SetTransformationMatrix(const glm::mat4& matrix)
     {
-        glm::vec3 skew;
+        glm::vec3 position, scale, skew;
+        glm::fquat rotation;
         glm::vec4 perspective;
-        glm::decompose(matrix, m_scale_, m_rotation_, m_position_, skew, perspective);
+        glm::decompose(matrix, scale, rotation, position, skew, perspective);
 
-        PropagateTransformChange();
+        SetTransform(position, rotation, scale);
     }
 
     void Transform3DComponent::SetTransform(const glm::vec3& position,
                                             const glm::fquat& rotation,
                                             const glm::vec3& scale)
     {
-        m_position_ = position;
-        m_rotation_ = rotation;
-        m_scale_    = scale;
-        PropagateTransformChange();
+        TransformStorage& transform_storage = GetTransformStorage();
+        transform_storage.SetPosition(m_hierarchy_index, position);
+        transform_storage.SetRotation(m_hierarchy_index, rotation);
+        transform_storage.SetScale(m_hierarchy_index, scale);
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::SetPosition(const glm::vec3& position)
     {
-        m_position_ = position;
-        PropagateTransformChange();
+        GetTransformStorage().SetPosition(m_hierarchy_index, position);
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::SetRotation(const glm::fquat& rotation)
     {
-        m_rotation_ = rotation;
-        PropagateTransformChange();
+        GetTransformStorage().SetRotation(m_hierarchy_index, rotation);
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::Translate(const glm::vec3& translation)
     {
-        m_position_ += translation;
-        PropagateTransformChange();
+        TransformStorage& transform_storage = GetTransformStorage();
+        transform_storage.SetPosition(m_hierarchy_index, transform_storage.GetPosition(m_hierarchy_index) + translation);
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::Rotate(const glm::fquat& rotation)
     {
-        m_rotation_ = rotation * m_rotation_;
-        PropagateTransformChange();
+        TransformStorage& transform_storage = GetTransformStorage();
+        transform_storage.SetRotation(m_hierarchy_index, rotation * transform_storage.GetRotation(m_hierarchy_index));
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::Rotate(float angle,
                                       const glm::vec3& axis)
     {
         glm::fquat rotation(angle, axis);
-        m_rotation_ = rotation * m_rotation_;
-        PropagateTransformChange();
+        TransformStorage& transform_storage = GetTransformStorage();
+        transform_storage.SetRotation(m_hierarchy_index, rotation * transform_storage.GetRotation(m_hierarchy_index));
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::SetScale(glm::vec3 scale)
     {
-        m_scale_ = scale;
-        PropagateTransformChange();
+        GetTransformStorage().SetScale(m_hierarchy_index, scale);
+        MarkGlobalDirty();
+    }
+
+    glm::vec3 Transform3DComponent::GetLocalPosition() const
+    {
+        return GetTransformStorage().GetPosition(m_hierarchy_index);
+    }
+
+    glm::fquat Transform3DComponent::GetLocalRotation() const
+    {
+        return GetTransformStorage().GetRotation(m_hierarchy_index);
+    }
+
+    glm::vec3 Transform3DComponent::GetLocalScale() const
+    {
+        return GetTransformStorage().GetScale(m_hierarchy_index);
     }
 
     glm::vec3 Transform3DComponent::GetGlobalPosition() const
@@ -133,54 +158,46 @@ namespace brr
 
     glm::mat4 Transform3DComponent::GetMatrix() const
     {
-        glm::mat4 local_transform = glm::mat4_cast(m_rotation_);
-        local_transform = glm::scale(local_transform, m_scale_);
-        local_transform[3] = glm::vec4(m_position_, 1.0);
+        const TransformStorage& transform_storage = GetTransformStorage();
+        glm::mat4 local_transform = glm::mat4_cast(transform_storage.GetRotation(m_hierarchy_index));
+        local_transform = glm::scale(local_transform, transform_storage.GetScale(m_hierarchy_index));
+        local_transform[3] = glm::vec4(transform_storage.GetPosition(m_hierarchy_index), 1.0);
         //local_transform = local_transform * glm::translate(m_position_);
         return local_transform;
     }
 
     const glm::mat4& Transform3DComponent::GetGlobalMatrix() const
     {
-        if (m_dirty_ & GLOBAL_DIRTY)
-        {
-            m_global_transform_ = GetMatrix();
-            if (NodeComponent* parent = GetNodeComponent()->GetParentNode())
-            {
-                Transform3DComponent& parent_transform = parent->GetEntity().GetComponent<Transform3DComponent>();
-                m_global_transform_                    = parent_transform.GetGlobalMatrix() * m_global_transform_;
-            }
-            m_dirty_ &= ~GLOBAL_DIRTY;
-        }
-        return m_global_transform_;
+        return GetTransformStorage().GetWorldMatrix(m_hierarchy_index);
     }
 
     void Transform3DComponent::SetParent(Transform3DComponent* parent)
     {
         GetNodeComponent()->SetParent(parent->GetNodeComponent());
-        PropagateTransformChange();
+        MarkGlobalDirty();
     }
 
     void Transform3DComponent::RemoveChild(Transform3DComponent* child)
     {
         assert((child != nullptr) && "You can't remove null child.");
         GetNodeComponent()->RemoveChild(child->GetNodeComponent());
-        child->PropagateTransformChange();
+        GetScene()->ParentChanged(child->GetNodeComponent());
+        child->MarkGlobalDirty();
     }
 
-    void Transform3DComponent::PropagateTransformChange()
+    void Transform3DComponent::MarkGlobalDirty()
     {
-        m_dirty_ |= DirtyFlags::GLOBAL_DIRTY;
-        vis::SceneRenderProxy* scene_renderer_proxy = GetScene()->GetSceneRendererProxy();
-        if (scene_renderer_proxy)
+        // Transforms that are already dirty are in the Scene's dirty list.
+        if (m_dirty_ & GLOBAL_DIRTY)
         {
-            scene_renderer_proxy->UpdateRenderEntityTransform(*this);
+            return;
         }
+        m_dirty_ |= GLOBAL_DIRTY;
+        GetScene()->TransformChanged(this);
+    }
 
-        for (NodeComponent* child : GetNodeComponent()->m_children)
-        {
-            Transform3DComponent& child_transform = child->GetEntity().GetComponent<Transform3DComponent>();
-            child_transform.PropagateTransformChange();
-        }
+    TransformStorage& Transform3DComponent::GetTransformStorage() const
+    {
+        return GetScene()->m_transform_storage;
     }
 }
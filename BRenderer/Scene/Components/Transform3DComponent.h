@@ -8,8 +8,16 @@ namespace brr
 {
     struct NodeComponent;
 
-	struct alignas(64) Transform3DComponent : public EntityComponent
+    class TransformStorage;
+
+	/**
+	 * \brief Transform of a Scene entity. Its local values and world matrix are stored in the Scene's TransformStorage.
+	 */
+	struct Transform3DComponent : public EntityComponent
 	{
+		// Scene keeps pointers to the transforms in its flattened hierarchy, so they must not move on removal.
+		static constexpr auto in_place_delete = true;
+
 		enum DirtyFlags
 		{
 			NOT_DIRTY = 0,
@@ -18,6 +26,8 @@ namespace brr
 
         explicit Transform3DComponent ();
 
+        void OnInit();
+
 		void SetTransformationMatrix(const glm::mat4& matrix);
 		void SetTransform(const glm::vec3& position, const glm::fquat& rotation, const glm::vec3& scale);
 
@@ -30,10 +40,10 @@ namespace brr
                     const glm::vec3& axis);
         void SetScale(glm::vec3 scale);
 
-        [[nodiscard]] const glm::vec3& GetLocalPosition() const { return m_position_; }
-        [[nodiscard]] const glm::fquat& GetLocalRotation() const { return m_rotation_; }
-        [[nodiscard]] const glm::vec3& GetLocalScale() const { return m_scale_; }
-        [[nodiscard]] glm::vec3 GetLocalRotationEuler() const { return glm::eulerAngles(m_rotation_); }
+        [[nodiscard]] glm::vec3 GetLocalPosition() const;
+        [[nodiscard]] glm::fquat GetLocalRotation() const;
+        [[nodiscard]] glm::vec3 GetLocalScale() const;
+        [[nodiscard]] glm::vec3 GetLocalRotationEuler() const { return glm::eulerAngles(GetLocalRotation()); }
 
         [[nodiscard]] glm::vec3 GetGlobalPosition() const;
         [[nodiscard]] glm::fquat GetGlobalRotation() const;
@@ -41,6 +51,11 @@ namespace brr
         [[nodiscard]] glm::vec3 GetGlobalRotationEuler() const;
 
         [[nodiscard]] glm::mat4 GetMatrix() const;
+
+        /**
+         * \brief Get the world matrix resolved on the last `Scene::Update`.
+         *        Changes made to this transform or its ancestors since then are not reflected until the next update.
+         */
         [[nodiscard]] const glm::mat4& GetGlobalMatrix() const;
 
         [[nodiscard]] DirtyFlags Dirty() const { return static_cast<DirtyFlags>(m_dirty_); }
@@ -56,18 +71,22 @@ namespace brr
 		void UnregisterGraphics();
 
     private:
-        void PropagateTransformChange();
+        friend class Scene;
+
+        /**
+         * \brief Mark the world matrix as dirty, so it is resolved with its subtree on the next `Scene::Update`.
+         */
+        void MarkGlobalDirty();
 
-        glm::fquat m_rotation_{1.0, 0.0, 0.0, 0.0};
-        glm::vec3 m_scale_{1.0f};
-        glm::vec3 m_position_{0.0f};
+        [[nodiscard]] TransformStorage& GetTransformStorage() const;
 
-        mutable uint8_t m_dirty_{GLOBAL_DIRTY};
+        uint8_t m_dirty_{GLOBAL_DIRTY};
 
         render::EntityID m_render_entity_id = render::EntityID::NULL_ID;
 
-        alignas(16) mutable glm::mat4 m_global_transform_{1.f};
-        // align matrix with 16 so it occupies exactly the second cache line.
+        // Index in the Scene's TransformStorage. After the hierarchy is rebuilt, it is also the index in the Scene's
+        // flattened hierarchy.
+        uint32_t m_hierarchy_index = 0;
     };
 }
 
@@ -38,6 +38,13 @@ namespace brr
 		template<typename... T>
 		[[nodiscard]] bool HasAllComponents() const;
 
+		/**
+		 * \brief Notify the Scene that the component T of this entity changed.
+		 *        Its graphics are updated once on the next Scene::Update, however many times it changed.
+		 */
+		template <ComponentType T>
+		void MarkComponentChanged() const;
+
 		bool IsValid() const { return m_entity != entt::null && m_scene != nullptr; }
 		operator bool() const { return IsValid(); }
 
@@ -133,6 +140,13 @@ namespace brr
 		return m_scene->m_registry.all_of<T...>(m_entity);
 	}
 
+    template <ComponentType T>
+    void Entity::MarkComponentChanged() const
+    {
+		assert(IsValid() && "Entity must be valid to mark a component as changed.");
+		m_scene->m_registry.patch<T>(m_entity);
+    }
+
     template <ComponentType T>
     void Entity::OnComponentDestroyed(entt::registry& registry,
         entt::entity entity)
@@ -1,6 +1,8 @@
 #include "Scene.h"
 
 #include <Core/LogSystem.h>
+#include <Core/Threading/ParallelFor.h>
+#include <Core/Threading/ThreadPool.h>
 
 #include <Renderer/RenderThread.h>
 
@@ -12,6 +14,10 @@
 
 namespace brr
 {
+	static constexpr uint32_t INVALID_HIERARCHY_INDEX = static_cast<uint32_t>(-1);
+	// Subtrees with fewer nodes than this are always resolved on the calling thread.
+	static constexpr uint32_t MIN_PARALLEL_SUBTREE_SIZE = 4096;
+
 	template <ComponentType T>
 	void RegisterComponentGraphics(entt::registry& scene_registry)
 	{
@@ -32,9 +38,40 @@ namespace brr
 		}
 	}
 
+	template <ComponentType T>
+	void UpdateChangedComponentGraphics(entt::registry& scene_registry, entt::observer& changed_components, bool update_graphics)
+	{
+		if (update_graphics)
+		{
+		    for (entt::entity entity : changed_components)
+		    {
+		        scene_registry.get<T>(entity).UpdateGraphics();
+		    }
+		}
+		changed_components.clear();
+	}
+
+	template <ComponentType T>
+	void UnregisterComponentGraphics(entt::registry& scene_registry, std::span<const entt::entity> entities)
+	{
+		for (entt::entity entity : entities)
+		{
+		    if (T* component = scene_registry.try_get<T>(entity))
+		    {
+		        component->UnregisterGraphics();
+		    }
+		}
+	}
+
 	Scene::Scene()
 	: m_main_camera(entt::null)
-	{}
+	{
+		m_changed_cameras.connect(m_registry, entt::collector.update<PerspectiveCameraComponent>());
+		m_changed_point_lights.connect(m_registry, entt::collector.update<PointLightComponent>());
+		m_changed_directional_lights.connect(m_registry, entt::collector.update<DirectionalLightComponent>());
+		m_changed_spot_lights.connect(m_registry, entt::collector.update<SpotLightComponent>());
+		m_changed_ambient_lights.connect(m_registry, entt::collector.update<AmbientLightComponent>());
+	}
 
 	Scene::~Scene()
 	{
@@ -50,6 +87,8 @@ namespace brr
 			return;
 		}
 
+		// Render entities are created with the current world matrices.
+		UpdateTransforms();
 		m_scene_render_proxy = std::make_unique<vis::SceneRenderProxy>();
 		
 
@@ -128,39 +167,137 @@ namespace brr
 
 		if (is_root)
 		{
-		    m_root_nodes.push_back(new_entity);
+		    m_root_nodes.emplace(new_entity);
+		    m_hierarchy_dirty = true;
 		}
+		// New transforms start dirty, so they are not added to the dirty list by 'MarkGlobalDirty'.
+		m_dirty_transforms.push_back(new_entity);
 
 		return Entity{new_entity, this};
 	}
 
     void Scene::RemoveEntity(Entity entity)
     {
-		if (!m_registry.valid(entity.m_entity))
+		RemoveEntities({&entity, 1});
+    }
+
+    void Scene::RemoveEntities(std::span<const Entity> entities)
+    {
+		// Collect the entities and their descendants.
+		std::vector<entt::entity> removed_entities;
+		std::vector<const NodeComponent*> node_stack;
+		for (const Entity& entity : entities)
 		{
-		    BRR_LogError("Trying to remove invalid entity. Entity Id '{}' is not valid.", uint32_t(entity.m_entity));
-			return;
+		    if (entity.m_scene != this || !m_registry.valid(entity.m_entity))
+		    {
+		        BRR_LogError("Trying to remove invalid entity. Entity Id '{}' is not valid.", uint32_t(entity.m_entity));
+				continue;
+		    }
+
+			node_stack.push_back(&m_registry.get<NodeComponent>(entity.m_entity));
+			while (!node_stack.empty())
+			{
+			    const NodeComponent* node = node_stack.back();
+				node_stack.pop_back();
+
+				removed_entities.push_back(node->GetEntity().m_entity);
+				node_stack.insert(node_stack.end(), node->GetChildren().begin(), node->GetChildren().end());
+			}
+		}
+
+		if (removed_entities.empty())
+		{
+		    return;
 		}
 
-		NodeComponent& node = entity.GetComponent<NodeComponent>();
+		// Entities removed together with one of their ancestors are collected twice.
+		std::ranges::sort(removed_entities);
+		removed_entities.erase(std::ranges::unique(removed_entities).begin(), removed_entities.end());
+		auto is_removed = [&removed_entities](entt::entity entity)
+		{
+		    return std::ranges::binary_search(removed_entities, entity);
+		};
 
-        if (NodeComponent* parent_node = node.GetParentNode())
+		// Detach the removed subtrees from the remaining nodes. Each parent is visited once, however many children it loses.
+		std::vector<NodeComponent*> remaining_parents;
+		for (entt::entity removed_entity : removed_entities)
 		{
-		    parent_node->RemoveChild(&node);
+		    NodeComponent* parent_node = m_registry.get<NodeComponent>(removed_entity).GetParentNode();
+			if (!parent_node)
+			{
+			    m_root_nodes.remove(removed_entity);
+			}
+			else if (!is_removed(parent_node->GetEntity().m_entity))
+			{
+			    remaining_parents.push_back(parent_node);
+			}
+		}
+		std::ranges::sort(remaining_parents);
+		remaining_parents.erase(std::ranges::unique(remaining_parents).begin(), remaining_parents.end());
+		for (NodeComponent* parent_node : remaining_parents)
+		{
+		    std::erase_if(parent_node->m_children, [&is_removed](const NodeComponent* child)
+		    {
+		        return is_removed(child->GetEntity().m_entity);
+		    });
+		}
+
+		if (m_scene_render_proxy)
+		{
+		    UnregisterComponentGraphics<Mesh3DComponent>(m_registry, removed_entities);
+
+			// Cameras and lights are destroyed in the same command as the render entities. Their IDs are
+			// cleared so the component destructors don't send one command each.
+			std::vector<render::EntityID> render_entity_ids;
+			std::vector<render::CameraID> camera_ids;
+			std::vector<render::LightID> light_ids;
+			render_entity_ids.reserve(removed_entities.size());
+			auto take_light_id = [&light_ids](auto* light)
+			{
+			    if (light && light->m_light_id != render::LightID::NULL_ID)
+			    {
+			        light_ids.push_back(light->m_light_id);
+					light->m_light_id = render::LightID::NULL_ID;
+			    }
+			};
+			for (entt::entity removed_entity : removed_entities)
+			{
+			    Transform3DComponent& transform = m_registry.get<Transform3DComponent>(removed_entity);
+				if (transform.m_render_entity_id != render::EntityID::NULL_ID)
+				{
+				    render_entity_ids.push_back(transform.m_render_entity_id);
+					transform.m_render_entity_id = render::EntityID::NULL_ID;
+				}
+
+				PerspectiveCameraComponent* camera = m_registry.try_get<PerspectiveCameraComponent>(removed_entity);
+				if (camera && camera->m_camera_id != render::CameraID::NULL_ID)
+				{
+				    camera_ids.push_back(camera->m_camera_id);
+					camera->m_camera_id = render::CameraID::NULL_ID;
+				}
+
+				take_light_id(m_registry.try_get<PointLightComponent>(removed_entity));
+				take_light_id(m_registry.try_get<DirectionalLightComponent>(removed_entity));
+				take_light_id(m_registry.try_get<SpotLightComponent>(removed_entity));
+				take_light_id(m_registry.try_get<AmbientLightComponent>(removed_entity));
+			}
+			m_scene_render_proxy->DestroyRenderEntities(render_entity_ids, camera_ids, light_ids);
 		}
 
-		for (NodeComponent* children : node.GetChildren())
+		if (is_removed(m_main_camera))
 		{
-		    RemoveEntity(children->GetEntity());
+		    m_main_camera = entt::null;
 		}
 
-		m_registry.destroy(entity.m_entity);
+		m_registry.destroy(removed_entities.begin(), removed_entities.end());
+		m_hierarchy_dirty = true;
     }
 
     std::vector<Entity> Scene::GetRootEntities() const
     {
 		std::vector<Entity> root_entities;
-		for (auto& root_entity : m_root_nodes)
+		root_entities.reserve(m_root_nodes.size());
+		for (entt::entity root_entity : m_root_nodes)
 		{
 		    root_entities.push_back({root_entity, const_cast<Scene*>(this)});
 		}
@@ -190,6 +327,11 @@ namespace brr
 
     void Scene::Update()
     {
+		m_system_scheduler.Run(m_registry, thread::ThreadPool::GetDefaultPool());
+
+		UpdateTransforms();
+		UpdateChangedComponents();
+
 		if (m_scene_render_proxy)
 		{
 		    m_scene_render_proxy->FlushUpdateCommands();
@@ -199,18 +341,188 @@ namespace brr
     void Scene::ParentChanged(NodeComponent* changed_node)
     {
 		entt::entity node_entity = changed_node->GetEntity().m_entity;
-		auto root_entt_iter = std::find(m_root_nodes.begin(), m_root_nodes.end(), node_entity);
-		bool is_currently_root = root_entt_iter != m_root_nodes.end();
+		bool is_currently_root = m_root_nodes.contains(node_entity);
 
 		// Node has a new parent. Remove from root nodes.
 		if (changed_node->GetParentNode() && is_currently_root)
 		{
-		    m_root_nodes.erase(root_entt_iter);
+		    m_root_nodes.erase(node_entity);
 		}
 		// Node have parent removed. Add it in root nodes.
 		else if (!changed_node->GetParentNode() && !is_currently_root)
 		{
-		    m_root_nodes.push_back(node_entity);
+		    m_root_nodes.emplace(node_entity);
+		}
+		m_hierarchy_dirty = true;
+    }
+
+    void Scene::TransformChanged(Transform3DComponent* changed_transform)
+    {
+		m_dirty_transforms.push_back(changed_transform->GetEntity().m_entity);
+    }
+
+    void Scene::UpdateTransforms()
+    {
+		if (m_dirty_transforms.empty())
+		{
+		    return;
+		}
+
+		if (m_hierarchy_dirty)
+		{
+		    RebuildTransformHierarchy();
+		}
+
+		// Dirty transforms are resolved in hierarchy order, skipping the ones inside an already resolved subtree.
+		m_dirty_hierarchy_indices.clear();
+		for (entt::entity dirty_entity : m_dirty_transforms)
+		{
+		    if (!m_registry.valid(dirty_entity))
+		    {
+		        continue;
+		    }
+			const Transform3DComponent* transform = m_registry.try_get<Transform3DComponent>(dirty_entity);
+			if (transform && (transform->m_dirty_ & Transform3DComponent::GLOBAL_DIRTY))
+			{
+			    m_dirty_hierarchy_indices.push_back(transform->m_hierarchy_index);
+			}
+		}
+		m_dirty_transforms.clear();
+		std::ranges::sort(m_dirty_hierarchy_indices);
+
+		uint32_t resolved_end = 0;
+		for (uint32_t dirty_index : m_dirty_hierarchy_indices)
+		{
+		    if (dirty_index < resolved_end)
+		    {
+		        continue;
+		    }
+			resolved_end = dirty_index + m_hierarchy_subtree_sizes[dirty_index];
+			ResolveTransformSubtree(dirty_index);
+
+			if (m_scene_render_proxy)
+			{
+			    for (uint32_t index = dirty_index; index < resolved_end; index++)
+			    {
+			        m_scene_render_proxy->UpdateRenderEntityTransform(*m_hierarchy_transforms[index]);
+			    }
+			}
+		}
+    }
+
+    void Scene::UpdateChangedComponents()
+    {
+		// Without a SceneRenderer, the changes are dropped. Graphics are created with the current values when it is initialized.
+		const bool update_graphics = m_scene_render_proxy != nullptr;
+		UpdateChangedComponentGraphics<PerspectiveCameraComponent>(m_registry, m_changed_cameras, update_graphics);
+		UpdateChangedComponentGraphics<PointLightComponent>(m_registry, m_changed_point_lights, update_graphics);
+		UpdateChangedComponentGraphics<DirectionalLightComponent>(m_registry, m_changed_directional_lights, update_graphics);
+		UpdateChangedComponentGraphics<SpotLightComponent>(m_registry, m_changed_spot_lights, update_graphics);
+		UpdateChangedComponentGraphics<AmbientLightComponent>(m_registry, m_changed_ambient_lights, update_graphics);
+    }
+
+    void Scene::RebuildTransformHierarchy()
+    {
+		m_hierarchy_transforms.clear();
+		m_hierarchy_parents.clear();
+		m_hierarchy_subtree_sizes.clear();
+		// Current storage index of each node, in hierarchy order.
+		std::vector<uint32_t> storage_order;
+
+		// Iterative depth-first traversal. Nodes are pushed in reverse, so children keep their order.
+		std::vector<std::pair<const NodeComponent*, uint32_t>> node_stack;
+		for (entt::entity root_entity : m_root_nodes)
+		{
+		    node_stack.emplace_back(&m_registry.get<NodeComponent>(root_entity), INVALID_HIERARCHY_INDEX);
+		}
+
+		while (!node_stack.empty())
+		{
+		    const auto [node, parent_index] = node_stack.back();
+			node_stack.pop_back();
+
+			const uint32_t node_index = static_cast<uint32_t>(m_hierarchy_transforms.size());
+			Transform3DComponent& transform = m_registry.get<Transform3DComponent>(node->GetEntity().m_entity);
+			storage_order.push_back(transform.m_hierarchy_index);
+			transform.m_hierarchy_index = node_index;
+			m_hierarchy_transforms.push_back(&transform);
+			m_hierarchy_parents.push_back(parent_index);
+			m_hierarchy_subtree_sizes.push_back(1);
+
+			const std::vector<NodeComponent*>& children = node->GetChildren();
+			for (auto child_iter = children.rbegin(); child_iter != children.rend(); ++child_iter)
+			{
+			    node_stack.emplace_back(*child_iter, node_index);
+			}
+		}
+
+		// Transforms of removed entities are not in the hierarchy, so they are dropped from the storage.
+		m_transform_storage.Reorder(storage_order);
+
+		// Children come after their parents, so a reverse sweep accumulates the subtree sizes.
+		for (size_t index = m_hierarchy_parents.size(); index-- > 0;)
+		{
+		    if (m_hierarchy_parents[index] != INVALID_HIERARCHY_INDEX)
+		    {
+		        m_hierarchy_subtree_sizes[m_hierarchy_parents[index]] += m_hierarchy_subtree_sizes[index];
+		    }
+		}
+
+		m_hierarchy_dirty = false;
+    }
+
+    void Scene::ResolveTransformSubtree(uint32_t root_index)
+    {
+		const uint32_t subtree_end = root_index + m_hierarchy_subtree_sizes[root_index];
+		if (m_hierarchy_subtree_sizes[root_index] < MIN_PARALLEL_SUBTREE_SIZE)
+		{
+		    ResolveTransformRange(root_index, subtree_end);
+			return;
+		}
+
+		// Resolve the chain of single children until a node with more than one child subtree is found.
+		std::vector<uint32_t> child_subtrees;
+		uint32_t node_index = root_index;
+		while (true)
+		{
+		    ResolveTransformRange(node_index, node_index + 1);
+			const uint32_t node_end = node_index + m_hierarchy_subtree_sizes[node_index];
+			child_subtrees.clear();
+			for (uint32_t child_index = node_index + 1; child_index < node_end; child_index += m_hierarchy_subtree_sizes[child_index])
+			{
+			    child_subtrees.push_back(child_index);
+			}
+			if (child_subtrees.size() != 1)
+			{
+			    break;
+			}
+			node_index = child_subtrees.front();
+		}
+
+		// Child subtrees are disjoint ranges that only read the already resolved parent.
+		thread::ParallelFor(0, child_subtrees.size(), [this, &child_subtrees](size_t begin, size_t end)
+		{
+		    for (size_t idx = begin; idx < end; idx++)
+		    {
+		        const uint32_t child_index = child_subtrees[idx];
+				ResolveTransformRange(child_index, child_index + m_hierarchy_subtree_sizes[child_index]);
+		    }
+		});
+    }
+
+    void Scene::ResolveTransformRange(uint32_t begin, uint32_t end)
+    {
+		// Local matrices are built in batch, then multiplied in place by the world matrix of their parents.
+		m_transform_storage.ComposeLocalMatrices(begin, end);
+		for (uint32_t index = begin; index < end; index++)
+		{
+			const uint32_t parent_index = m_hierarchy_parents[index];
+			if (parent_index != INVALID_HIERARCHY_INDEX)
+			{
+			    glm::mat4& world_matrix = m_transform_storage.GetWorldMatrix(index);
+			    world_matrix = m_transform_storage.GetWorldMatrix(parent_index) * world_matrix;
+			}
+			m_hierarchy_transforms[index]->m_dirty_ = Transform3DComponent::NOT_DIRTY;
 		}
     }
 }
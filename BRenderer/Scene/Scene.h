@@ -4,6 +4,8 @@
 #include <Core/thirdpartiesInc.h>
 #include <Core/Events/Event.h>
 
+#include <Scene/SystemScheduler.h>
+#include <Scene/TransformStorage.h>
 #include <Visualization/SceneRendererProxy.h>
 
 namespace brr
@@ -23,6 +25,18 @@ namespace brr
 
 		void RemoveEntity(Entity entity);
 
+		/**
+		 * \brief Remove the entities and all their descendants.
+		 *
+		 * The subtrees are collected iteratively and destroyed in bulk. Their render entities, cameras and lights
+		 * are destroyed with a single command.
+		 */
+		void RemoveEntities(std::span<const Entity> entities);
+
+		/**
+		 * \brief Get the entities without a parent.
+		 * \return The root entities, in no particular order. Removing a root moves the last one into its place.
+		 */
 		std::vector<Entity> GetRootEntities() const;
 
         PerspectiveCameraComponent* GetMainCamera();
@@ -30,20 +44,64 @@ namespace brr
 
 		vis::SceneRenderProxy* GetSceneRendererProxy() const { return m_scene_render_proxy.get(); }
 
+		// Systems run at the start of each Scene::Update.
+		SystemScheduler& GetSystemScheduler() { return m_system_scheduler; }
+
 		void Update();
 
 	private:
 		
 		friend class Entity;
 		friend struct NodeComponent;
+		friend struct Transform3DComponent;
 		template <typename...>
 		friend class SceneComponentsView;
 
 		void ParentChanged(NodeComponent* changed_node);
+		void TransformChanged(Transform3DComponent* changed_transform);
+
+		/**
+		 * \brief Resolve the world matrices of the transforms changed since the last call, and of their descendants,
+		 *        and send them to the SceneRenderer.
+		 */
+		void UpdateTransforms();
+
+		// Update the graphics of the components marked as changed since the last call.
+		void UpdateChangedComponents();
+
+		void RebuildTransformHierarchy();
+
+		// Resolve the subtree of the node 'root_index'. The direct subtrees of wide nodes are resolved in parallel.
+		void ResolveTransformSubtree(uint32_t root_index);
+		// Resolve the nodes in [begin, end). Parents outside the range must already be resolved.
+		void ResolveTransformRange(uint32_t begin, uint32_t end);
 
 		entt::registry m_registry {};
 
-		std::vector<entt::entity> m_root_nodes {};
+		SystemScheduler m_system_scheduler {};
+
+		// Entities without a parent. Unordered: removal swaps the last root into the freed position.
+		entt::sparse_set m_root_nodes {};
+
+		// Transform hierarchy flattened in depth-first order. Every parent comes before its children,
+		// and the subtree of each node is the contiguous range [index, index + subtree size).
+		// The transform storage is kept in the same order.
+		TransformStorage m_transform_storage {};
+		std::vector<Transform3DComponent*> m_hierarchy_transforms {};
+		std::vector<uint32_t> m_hierarchy_parents {};
+		std::vector<uint32_t> m_hierarchy_subtree_sizes {};
+		bool m_hierarchy_dirty = true;
+
+		// Entities whose transform changed since the last update.
+		std::vector<entt::entity> m_dirty_transforms {};
+		std::vector<uint32_t> m_dirty_hierarchy_indices {};
+
+		// Entities whose component was marked as changed with 'Entity::MarkComponentChanged' since the last update.
+		entt::observer m_changed_cameras {};
+		entt::observer m_changed_point_lights {};
+		entt::observer m_changed_directional_lights {};
+		entt::observer m_changed_spot_lights {};
+		entt::observer m_changed_ambient_lights {};
 
 		std::unique_ptr<vis::SceneRenderProxy> m_scene_render_proxy {};
 
@@ -0,0 +1,101 @@
+#include "SystemScheduler.h"
+
+#include <Core/Threading/TaskGraph.h>
+#include <Core/Threading/ThreadPool.h>
+
+#include <chrono>
+
+namespace brr
+{
+	namespace
+	{
+		float ElapsedMilliseconds(std::chrono::steady_clock::time_point start_time)
+		{
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+		}
+	}
+
+	void SystemScheduler::Clear()
+	{
+		m_organizer.clear();
+		m_graph.clear();
+		m_graph_dirty = false;
+		m_create_storages_functions.clear();
+		m_timings.clear();
+		m_last_run_ms = 0.0f;
+	}
+
+	void SystemScheduler::Run(entt::registry& registry, thread::ThreadPool& thread_pool)
+	{
+		if (m_graph_dirty)
+		{
+		    RebuildGraph();
+		}
+
+		if (m_graph.empty())
+		{
+		    m_last_run_ms = 0.0f;
+			return;
+		}
+
+		// Create the storages and context variables used by the systems up front, so concurrent systems never create them.
+		for (CreateStoragesFunction* create_storages : m_create_storages_functions)
+		{
+		    create_storages(registry);
+		}
+		for (const entt::organizer::vertex& vertex : m_graph)
+		{
+		    vertex.prepare(registry);
+		}
+
+		const auto run_start = std::chrono::steady_clock::now();
+		if (m_single_threaded || thread_pool.WorkersCount() == 0)
+		{
+			// Systems are added after the systems they depend on, so the insertion order respects every dependency.
+		    for (size_t system_index = 0; system_index < m_graph.size(); system_index++)
+		    {
+		        RunSystem(system_index, registry);
+		    }
+		}
+		else
+		{
+		    thread::TaskGraph task_graph;
+			for (size_t system_index = 0; system_index < m_graph.size(); system_index++)
+			{
+			    task_graph.AddTask([this, system_index, &registry]
+			    {
+			        RunSystem(system_index, registry);
+			    });
+			}
+
+			for (size_t system_index = 0; system_index < m_graph.size(); system_index++)
+			{
+			    for (size_t dependent_index : m_graph[system_index].children())
+			    {
+			        task_graph.AddDependency(dependent_index, system_index);
+			    }
+			}
+
+			// The frame can't continue until the systems are finished.
+			task_graph.Submit(thread_pool, thread::WorkPriority::Critical);
+			task_graph.Wait();
+		}
+		m_last_run_ms = ElapsedMilliseconds(run_start);
+	}
+
+	void SystemScheduler::RebuildGraph()
+	{
+		m_graph = m_organizer.graph();
+		m_graph_dirty = false;
+	}
+
+	void SystemScheduler::RunSystem(size_t system_index, entt::registry& registry)
+	{
+		const entt::organizer::vertex& vertex = m_graph[system_index];
+
+		const auto system_start = std::chrono::steady_clock::now();
+		vertex.callback()(vertex.data(), registry);
+		// Each system only writes its own timing, so no synchronization is needed.
+		m_timings[system_index].duration_ms = ElapsedMilliseconds(system_start);
+	}
+}
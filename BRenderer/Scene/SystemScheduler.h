@@ -0,0 +1,178 @@
+#ifndef BRR_SYSTEMSCHEDULER_H
+#define BRR_SYSTEMSCHEDULER_H
+#include <Core/thirdpartiesInc.h>
+
+#include <entt/entity/organizer.hpp>
+
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace brr
+{
+	namespace thread
+	{
+		class ThreadPool;
+	}
+
+	namespace detail
+	{
+		// Component storages accessed through a system parameter. Only views access storages.
+		template <typename Param>
+		struct SystemParamStorages
+		{
+			using type = entt::type_list<>;
+		};
+
+		template <typename Entity, typename... Component, typename... Exclude>
+		struct SystemParamStorages<entt::basic_view<Entity, entt::get_t<Component...>, entt::exclude_t<Exclude...>>>
+		{
+			using type = entt::type_list<std::remove_const_t<Component>..., std::remove_const_t<Exclude>...>;
+		};
+
+		template <typename... Params>
+		using SystemStorages = entt::type_list_cat_t<typename SystemParamStorages<std::remove_cvref_t<Params>>::type...>;
+
+		// Declarations only, used to deduce the storages from the signature of a system.
+		template <typename Ret, typename... Params>
+		SystemStorages<Params...> FreeSystemStorages(Ret (*)(Params...));
+
+		template <typename Ret, typename Type, typename... Params>
+		SystemStorages<Params...> BoundSystemStorages(Ret (*)(Type&, Params...));
+
+		template <typename Ret, typename Class, typename... Params>
+		SystemStorages<Params...> BoundSystemStorages(Ret (Class::*)(Params...));
+
+		template <typename Ret, typename Class, typename... Params>
+		SystemStorages<Params...> BoundSystemStorages(Ret (Class::*)(Params...) const);
+	}
+
+	/**
+	 * \brief Runs the systems of a Scene each frame, running systems that don't conflict concurrently on a ThreadPool.
+	 *
+	 * The components read and written by a system are deduced from its parameters, as in entt::organizer: views of
+	 * const components are read-only, views of non-const components are read-write, and a non-const registry gives
+	 * the system exclusive access. Components accessed without a view are declared with the 'Req' template parameters.
+	 * Systems conflict when one of them writes a component the other accesses. Conflicting systems run in the order
+	 * they were added.
+	 *
+	 * Component methods that notify the Scene (e.g. transform and light setters) only touch state owned by the
+	 * component type, so a system calling them must declare the component as read-write.
+	 */
+	class SystemScheduler
+	{
+	public:
+		struct SystemTiming
+		{
+			const char* name = nullptr;
+			// Duration of the last run of the system.
+			float duration_ms = 0.0f;
+		};
+
+		/**
+		 * \brief Add a free function as a system.
+		 * \tparam System Function to run. Its parameters must be views, the registry or context variables.
+		 * \tparam Req Components accessed without a view. Const types are read-only.
+		 */
+		template <auto System, typename... Req>
+		void AddSystem(const char* name);
+
+		/**
+		 * \brief Add a member function, or a free function with a payload as first parameter, as a system.
+		 *        'instance' must outlive the scheduler or be removed with 'Clear'.
+		 */
+		template <auto System, typename... Req, typename Type>
+		void AddSystem(Type& instance, const char* name);
+
+		/**
+		 * \brief Remove every system.
+		 */
+		void Clear();
+
+		/**
+		 * \brief Run every system, one at a time on the calling thread, in the order they were added.
+		 *        Used to debug systems with a deterministic execution order.
+		 */
+		void SetSingleThreaded(bool single_threaded) { m_single_threaded = single_threaded; }
+
+		[[nodiscard]] bool IsSingleThreaded() const { return m_single_threaded; }
+
+		/**
+		 * \brief Run every system once. Returns when all systems are finished.
+		 */
+		void Run(entt::registry& registry, thread::ThreadPool& thread_pool);
+
+		[[nodiscard]] size_t SystemsCount() const { return m_timings.size(); }
+
+		/**
+		 * \brief Duration of each system on the last run, in the order they were added.
+		 */
+		[[nodiscard]] std::span<const SystemTiming> GetSystemTimings() const { return m_timings; }
+
+		/**
+		 * \brief Duration of the last run, from the start of the first system to the end of the last one.
+		 */
+		[[nodiscard]] float GetLastRunDurationMs() const { return m_last_run_ms; }
+
+	private:
+		using CreateStoragesFunction = void(entt::registry&);
+
+		template <typename Storages>
+		static void CreateStorages(entt::registry& registry);
+
+		void RebuildGraph();
+
+		void RunSystem(size_t system_index, entt::registry& registry);
+
+		entt::organizer m_organizer {};
+		// Graph of the systems, rebuilt when systems are added. Children of each vertex are the systems that depend on it.
+		std::vector<entt::organizer::vertex> m_graph {};
+		bool m_graph_dirty = false;
+		// Create the storages of the components accessed by each system.
+		std::vector<CreateStoragesFunction*> m_create_storages_functions {};
+
+		std::vector<SystemTiming> m_timings {};
+		float m_last_run_ms = 0.0f;
+
+		bool m_single_threaded = false;
+	};
+
+	/**********************
+	 *** Implementation ***
+	 *********************/
+
+	template <typename Storages>
+	void SystemScheduler::CreateStorages(entt::registry& registry)
+	{
+		// Views of non-const components create the storages that don't exist yet.
+		[&registry]<typename... Component>(entt::type_list<Component...>)
+		{
+		    (static_cast<void>(registry.view<Component>()), ...);
+		}(Storages{});
+	}
+
+	template <auto System, typename ... Req>
+	void SystemScheduler::AddSystem(const char* name)
+	{
+		// Storages of the views in the system parameters and of the declared requirements, created before the systems run.
+		using Storages = entt::type_list_cat_t<decltype(detail::FreeSystemStorages(System)),
+		                                       entt::type_list<std::remove_const_t<Req>...>>;
+		m_organizer.emplace<System, Req...>(name);
+		m_create_storages_functions.push_back(&CreateStorages<Storages>);
+		m_timings.push_back({name});
+		m_graph_dirty = true;
+	}
+
+	template <auto System, typename ... Req, typename Type>
+	void SystemScheduler::AddSystem(Type& instance, const char* name)
+	{
+		using Storages = entt::type_list_cat_t<decltype(detail::BoundSystemStorages(System)),
+		                                       entt::type_list<std::remove_const_t<Req>...>>;
+		m_organizer.emplace<System, Req...>(instance, name);
+		m_create_storages_functions.push_back(&CreateStorages<Storages>);
+		m_timings.push_back({name});
+		m_graph_dirty = true;
+	}
+}
+
+#endif
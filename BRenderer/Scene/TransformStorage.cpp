@@ -0,0 +1,99 @@
+#include "TransformStorage.h"
+
+namespace brr
+{
+	namespace
+	{
+		void ReorderStream(std::vector<float>& stream, std::span<const uint32_t> new_order, std::vector<float>& scratch)
+		{
+			scratch.resize(new_order.size());
+			for (size_t index = 0; index < new_order.size(); index++)
+			{
+				scratch[index] = stream[new_order[index]];
+			}
+			stream.swap(scratch);
+		}
+	}
+
+	uint32_t TransformStorage::Add()
+	{
+		const uint32_t index = Size();
+
+		m_position_x.push_back(0.0f);
+		m_position_y.push_back(0.0f);
+		m_position_z.push_back(0.0f);
+
+		m_rotation_x.push_back(0.0f);
+		m_rotation_y.push_back(0.0f);
+		m_rotation_z.push_back(0.0f);
+		m_rotation_w.push_back(1.0f);
+
+		m_scale_x.push_back(1.0f);
+		m_scale_y.push_back(1.0f);
+		m_scale_z.push_back(1.0f);
+
+		m_world_matrices.emplace_back(1.0f);
+		return index;
+	}
+
+	void TransformStorage::Reorder(std::span<const uint32_t> new_order)
+	{
+		std::vector<float> scratch;
+		for (std::vector<float>* stream : {&m_position_x, &m_position_y, &m_position_z,
+		                                   &m_rotation_x, &m_rotation_y, &m_rotation_z, &m_rotation_w,
+		                                   &m_scale_x, &m_scale_y, &m_scale_z})
+		{
+			ReorderStream(*stream, new_order, scratch);
+		}
+
+		std::vector<glm::mat4> world_matrices (new_order.size());
+		for (size_t index = 0; index < new_order.size(); index++)
+		{
+			world_matrices[index] = m_world_matrices[new_order[index]];
+		}
+		m_world_matrices.swap(world_matrices);
+	}
+
+	void TransformStorage::SetPosition(uint32_t index, const glm::vec3& position)
+	{
+		m_position_x[index] = position.x;
+		m_position_y[index] = position.y;
+		m_position_z[index] = position.z;
+	}
+
+	void TransformStorage::SetRotation(uint32_t index, const glm::fquat& rotation)
+	{
+		m_rotation_x[index] = rotation.x;
+		m_rotation_y[index] = rotation.y;
+		m_rotation_z[index] = rotation.z;
+		m_rotation_w[index] = rotation.w;
+	}
+
+	void TransformStorage::SetScale(uint32_t index, const glm::vec3& scale)
+	{
+		m_scale_x[index] = scale.x;
+		m_scale_y[index] = scale.y;
+		m_scale_z[index] = scale.z;
+	}
+
+	void TransformStorage::ComposeLocalMatrices(uint32_t begin, uint32_t end)
+	{
+		ComposeTRSMatrices(GetStreams(), begin, end, m_world_matrices.data() + begin);
+	}
+
+	TRSStreams TransformStorage::GetStreams() const
+	{
+		return TRSStreams {
+			.position_x = m_position_x.data(),
+			.position_y = m_position_y.data(),
+			.position_z = m_position_z.data(),
+			.rotation_x = m_rotation_x.data(),
+			.rotation_y = m_rotation_y.data(),
+			.rotation_z = m_rotation_z.data(),
+			.rotation_w = m_rotation_w.data(),
+			.scale_x = m_scale_x.data(),
+			.scale_y = m_scale_y.data(),
+			.scale_z = m_scale_z.data()
+		};
+	}
+}
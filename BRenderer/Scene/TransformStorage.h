@@ -0,0 +1,73 @@
+#ifndef BRR_TRANSFORMSTORAGE_H
+#define BRR_TRANSFORMSTORAGE_H
+#include <Core/thirdpartiesInc.h>
+#include <Geometry/TransformKernels.h>
+
+#include <span>
+#include <vector>
+
+namespace brr
+{
+	/**
+	 * \brief Local translation, rotation and scale of the transforms of a Scene, and their world matrices.
+	 *
+	 * Each component of the local values is stored in a separate stream, so the local matrices of a range of
+	 * transforms are built by a SIMD kernel (see ComposeTRSMatrices). The Scene keeps the elements in the order of its
+	 * flattened hierarchy, reordering them with `Reorder` when the hierarchy changes.
+	 */
+	class TransformStorage
+	{
+	public:
+		/**
+		 * \brief Add a transform with identity local values and world matrix at the end of the streams.
+		 * \return Index of the new transform.
+		 */
+		uint32_t Add();
+
+		/**
+		 * \brief Move the element 'new_order[i]' to the index 'i'. Elements not present in 'new_order' are removed.
+		 */
+		void Reorder(std::span<const uint32_t> new_order);
+
+		[[nodiscard]] uint32_t Size() const { return static_cast<uint32_t>(m_world_matrices.size()); }
+
+		[[nodiscard]] glm::vec3 GetPosition(uint32_t index) const
+		{
+			return {m_position_x[index], m_position_y[index], m_position_z[index]};
+		}
+
+		[[nodiscard]] glm::fquat GetRotation(uint32_t index) const
+		{
+			return {m_rotation_w[index], m_rotation_x[index], m_rotation_y[index], m_rotation_z[index]};
+		}
+
+		[[nodiscard]] glm::vec3 GetScale(uint32_t index) const
+		{
+			return {m_scale_x[index], m_scale_y[index], m_scale_z[index]};
+		}
+
+		void SetPosition(uint32_t index, const glm::vec3& position);
+		void SetRotation(uint32_t index, const glm::fquat& rotation);
+		void SetScale(uint32_t index, const glm::vec3& scale);
+
+		[[nodiscard]] const glm::mat4& GetWorldMatrix(uint32_t index) const { return m_world_matrices[index]; }
+		[[nodiscard]] glm::mat4& GetWorldMatrix(uint32_t index) { return m_world_matrices[index]; }
+
+		/**
+		 * \brief Write the local matrices of the transforms [begin, end) to their world matrices,
+		 *        so the caller can multiply them by the world matrices of their parents in place.
+		 */
+		void ComposeLocalMatrices(uint32_t begin, uint32_t end);
+
+	private:
+		[[nodiscard]] TRSStreams GetStreams() const;
+
+		std::vector<float> m_position_x, m_position_y, m_position_z;
+		std::vector<float> m_rotation_x, m_rotation_y, m_rotation_z, m_rotation_w;
+		std::vector<float> m_scale_x, m_scale_y, m_scale_z;
+
+		std::vector<glm::mat4> m_world_matrices;
+	};
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include <Geometry/BoundsKernels.h>
+#include <Geometry/Frustum.h>
+#include <Geometry/TransformKernels.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace brr;
+
+namespace
+{
+	int s_failed_checks = 0;
+
+	void Check(bool condition, const char* description, size_t count, size_t begin)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s (count: %zu, begin: %zu)\n", description, count, begin);
+			s_failed_checks++;
+		}
+	}
+
+	struct TRSData
+	{
+		explicit TRSData(size_t count, std::mt19937& random)
+		: position_x(count), position_y(count), position_z(count),
+		  rotation_x(count), rotation_y(count), rotation_z(count), rotation_w(count),
+		  scale_x(count), scale_y(count), scale_z(count)
+		{
+			std::uniform_real_distribution<float> distribution (-10.0f, 10.0f);
+			for (size_t index = 0; index < count; index++)
+			{
+				const glm::quat rotation = glm::normalize(glm::quat(distribution(random), distribution(random),
+				                                                    distribution(random), distribution(random)));
+				position_x[index] = distribution(random);
+				position_y[index] = distribution(random);
+				position_z[index] = distribution(random);
+				rotation_x[index] = rotation.x;
+				rotation_y[index] = rotation.y;
+				rotation_z[index] = rotation.z;
+				rotation_w[index] = rotation.w;
+				scale_x[index]    = distribution(random);
+				scale_y[index]    = distribution(random);
+				scale_z[index]    = distribution(random);
+			}
+		}
+
+		TRSStreams GetStreams() const
+		{
+			return {position_x.data(), position_y.data(), position_z.data(),
+			        rotation_x.data(), rotation_y.data(), rotation_z.data(), rotation_w.data(),
+			        scale_x.data(), scale_y.data(), scale_z.data()};
+		}
+
+		// Reference path: mat4_cast, then scale, then translation.
+		glm::mat4 GetGlmMatrix(size_t index) const
+		{
+			const glm::quat rotation (rotation_w[index], rotation_x[index], rotation_y[index], rotation_z[index]);
+			glm::mat4 matrix = glm::mat4_cast(rotation);
+			matrix = glm::scale(matrix, glm::vec3(scale_x[index], scale_y[index], scale_z[index]));
+			matrix[3] = glm::vec4(position_x[index], position_y[index], position_z[index], 1.0f);
+			return matrix;
+		}
+
+		std::vector<float> position_x, position_y, position_z;
+		std::vector<float> rotation_x, rotation_y, rotation_z, rotation_w;
+		std::vector<float> scale_x, scale_y, scale_z;
+	};
+
+	// The kernels may contract multiplications and additions differently from glm.
+	bool NearlyEqual(const glm::mat4& first, const glm::mat4& second)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				const float tolerance = 1e-5f * std::max(1.0f, std::abs(second[column][row]));
+				if (std::abs(first[column][row] - second[column][row]) > tolerance)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void TestComposeTRSMatrices(std::mt19937& random)
+	{
+		// Odd counts leave a tail smaller than the SIMD width, and offsets start batches at unaligned elements.
+		const size_t counts[]  = {1, 3, 5, 7, 8, 9, 17, 1001};
+		const size_t begins[]  = {0, 1, 3, 5};
+		for (size_t count : counts)
+		{
+			for (size_t begin : begins)
+			{
+				const TRSData data (begin + count, random);
+				std::vector<glm::mat4> simd_matrices (count);
+				std::vector<glm::mat4> scalar_matrices (count);
+				ComposeTRSMatrices(data.GetStreams(), begin, begin + count, simd_matrices.data());
+				ComposeTRSMatricesScalar(data.GetStreams(), begin, begin + count, scalar_matrices.data());
+
+				bool matches_glm = true;
+				bool matches_scalar = true;
+				for (size_t index = 0; index < count; index++)
+				{
+					matches_glm    &= NearlyEqual(simd_matrices[index], data.GetGlmMatrix(begin + index));
+					matches_scalar &= NearlyEqual(simd_matrices[index], scalar_matrices[index]);
+				}
+				Check(matches_glm, "ComposeTRSMatrices matches glm", count, begin);
+				Check(matches_scalar, "ComposeTRSMatrices matches ComposeTRSMatricesScalar", count, begin);
+			}
+		}
+	}
+
+	void TestComputeVerticesBounds(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution (-50.0f, 50.0f);
+		const size_t counts[] = {0, 1, 2, 3, 4, 5, 1001};
+		for (size_t count : counts)
+		{
+			std::vector<Vertex3> vertices (count);
+			for (Vertex3& vertex : vertices)
+			{
+				vertex.pos = glm::vec3(distribution(random), distribution(random), distribution(random));
+				// The SIMD kernel loads 'u' with the position, so it must not leak into the bounds.
+				vertex.u   = 1e9f;
+			}
+
+			const AABBB simd_bounds   = ComputeVerticesBounds(vertices.data(), count);
+			const AABBB scalar_bounds = ComputeVerticesBoundsScalar(vertices.data(), count);
+			Check(simd_bounds.IsValid() == (count > 0), "ComputeVerticesBounds validity", count, 0);
+			if (count > 0)
+			{
+				Check(simd_bounds.GetMinPos() == scalar_bounds.GetMinPos() && simd_bounds.GetMaxPos() == scalar_bounds.GetMaxPos(),
+				      "ComputeVerticesBounds matches ComputeVerticesBoundsScalar", count, 0);
+			}
+		}
+	}
+
+	void TestCullAABBs(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> position_distribution (-300.0f, 300.0f);
+		std::uniform_real_distribution<float> extent_distribution (0.1f, 20.0f);
+		const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 200.0f);
+		const Frustum frustum = Frustum::FromProjectionView(projection);
+
+		const size_t counts[] = {0, 1, 7, 1001};
+		for (size_t count : counts)
+		{
+			std::vector<AABBB> bounds (count);
+			for (size_t index = 0; index < count; index++)
+			{
+				const glm::vec3 center (position_distribution(random), position_distribution(random), position_distribution(random));
+				const glm::vec3 extent (extent_distribution(random), extent_distribution(random), extent_distribution(random));
+				// Some invalid boxes, which are always visible.
+				bounds[index] = index % 50 == 0 ? AABBB() : AABBB(center - extent, center + extent);
+			}
+
+			std::vector<uint8_t> simd_visible (count);
+			std::vector<uint8_t> scalar_visible (count);
+			const size_t simd_count   = CullAABBs(frustum, bounds, simd_visible.data());
+			const size_t scalar_count = CullAABBsScalar(frustum, bounds, scalar_visible.data());
+			Check(simd_count == scalar_count && simd_visible == scalar_visible, "CullAABBs matches CullAABBsScalar", count, 0);
+
+			bool matches_classify = true;
+			for (size_t index = 0; index < count; index++)
+			{
+				uint8_t planes_mask = Frustum::ALL_PLANES_MASK;
+				const bool visible = !bounds[index].IsValid()
+				                   || frustum.Classify(bounds[index], planes_mask) != Frustum::Containment::Outside;
+				matches_classify &= visible == static_cast<bool>(simd_visible[index]);
+			}
+			Check(matches_classify, "CullAABBs matches Frustum::Classify", count, 0);
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 random (7);
+	TestComposeTRSMatrices(random);
+	TestComputeVerticesBounds(random);
+	TestCullAABBs(random);
+
+	if (s_failed_checks > 0)
+	{
+		std::printf("%d checks failed.\n", s_failed_checks);
+		return 1;
+	}
+	std::printf("All geometry kernel checks passed.\n");
+	return 0;
+}
@@ -9,7 +9,9 @@ namespace brr::vis
 {
     SceneRenderProxy::SceneRenderProxy()
     {
-        m_scene_renderer_id = RenderThread::RenderCmd_InitializeSceneRenderer();
+        std::unique_ptr<TransformChannel> transform_channel = std::make_unique<TransformChannel>();
+        m_transform_channel = transform_channel.get();
+        m_scene_renderer_id = RenderThread::RenderCmd_InitializeSceneRenderer(std::move(transform_channel));
     }
 
     SceneRenderProxy::~SceneRenderProxy()
@@ -21,20 +23,10 @@ namespace brr::vis
 
     void SceneRenderProxy::FlushUpdateCommands()
     {
-        for (EntityUpdatePair& entity_update_pair : m_entity_updates)
+        if (m_transform_channel->HasPendingWrites())
         {
-            RenderThread::SceneRenderCmd_UpdateEntityTransform(m_scene_renderer_id, entity_update_pair.first,
-                                                               entity_update_pair.second);
+            RenderThread::SceneRenderCmd_UpdateEntityTransforms(m_scene_renderer_id, m_transform_channel->Publish());
         }
-        m_entity_updates.Clear();
-
-        for (CameraUpdateData& camera_update_data : m_camera_updates)
-        {
-            RenderThread::SceneRenderCmd_UpdateCameraProjection(m_scene_renderer_id, camera_update_data.camera_id,
-                                                                camera_update_data.camera_fov_y, camera_update_data.camera_near,
-                                                                camera_update_data.camera_far);
-        }
-        m_camera_updates.Clear();
     }
 
     CameraID SceneRenderProxy::CreateCamera(const Transform3DComponent& owner_entity,
@@ -54,18 +46,9 @@ namespace brr::vis
     void SceneRenderProxy::UpdateCameraProjectionMatrix(CameraID camera_id,
                                                         float camera_fovy,
                                                         float camera_near,
-                                                        float camera_far)
+                                                        float camera_far) const
     {
-        CameraUpdateData update_data = {camera_id, camera_fovy, camera_near, camera_far};
-        auto camera_update_data = m_camera_updates.Find(camera_id);
-        if (camera_update_data == m_camera_updates.end())
-        {
-            m_camera_updates.AddObject(camera_id, update_data);
-        }
-        else
-        {
-            *camera_update_data = update_data;
-        }
+        RenderThread::SceneRenderCmd_UpdateCameraProjection(m_scene_renderer_id, camera_id, camera_fovy, camera_near, camera_far);
     }
 
     // Entities
@@ -77,22 +60,34 @@ namespace brr::vis
 
     void SceneRenderProxy::DestroyRenderEntity(const Transform3DComponent& entity_transform) const
     {
+        m_transform_channel->Discard(entity_transform.GetRenderEntityID());
         RenderThread::SceneRenderCmd_DestroyEntity(m_scene_renderer_id, entity_transform.GetRenderEntityID());
     }
 
-    void SceneRenderProxy::UpdateRenderEntityTransform(const Transform3DComponent& entity_transform)
+    void SceneRenderProxy::DestroyRenderEntities(std::span<const EntityID> entity_ids,
+                                                 std::span<const CameraID> camera_ids,
+                                                 std::span<const LightID> light_ids) const
     {
-        EntityID entity_id = entity_transform.GetRenderEntityID();
-        EntityUpdatePair update_pair = {entity_id, entity_transform.GetGlobalMatrix()};
-        auto entity_update_iter = m_entity_updates.Find(entity_id);
-        if (entity_update_iter == m_entity_updates.end())
+        if (entity_ids.empty() && camera_ids.empty() && light_ids.empty())
         {
-            m_entity_updates.AddObject(entity_id, update_pair);
+            return;
         }
-        else
+
+        for (EntityID entity_id : entity_ids)
+        {
+            m_transform_channel->Discard(entity_id);
+        }
+        RenderThread::SceneRenderCmd_DestroyEntities(m_scene_renderer_id, entity_ids, camera_ids, light_ids);
+    }
+
+    void SceneRenderProxy::UpdateRenderEntityTransform(const Transform3DComponent& entity_transform)
+    {
+        const EntityID entity_id = entity_transform.GetRenderEntityID();
+        if (entity_id == EntityID::NULL_ID)
         {
-            *entity_update_iter = update_pair;
+            return;
         }
+        m_transform_channel->Write(entity_id, entity_transform.GetGlobalMatrix());
     }
 
     // Surfaces
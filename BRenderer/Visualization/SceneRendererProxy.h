@@ -2,12 +2,13 @@
 #define BRR_SCENERENDERPROXY_H
 
 #include <cstdint>
+#include <span>
 
-#include <Core/Storage/ContiguousPool.h>
 #include <Core/thirdpartiesInc.h>
 
 #include <Renderer/SceneObjectsIDs.h>
 #include <Renderer/RenderingResourceIDs.h>
+#include <Renderer/TransformChannel.h>
 
 namespace brr
 {
@@ -39,13 +40,18 @@ namespace brr::vis
         void UpdateCameraProjectionMatrix(render::CameraID camera_id,
                                           float camera_fovy,
                                           float camera_near,
-                                          float camera_far);
+                                          float camera_far) const;
 
         // Render Entity
         render::EntityID CreateRenderEntity(const Transform3DComponent& entity_transform) const;
 
         void DestroyRenderEntity(const Transform3DComponent& entity_transform) const;
 
+        // Cameras and lights are destroyed in the same command, before the entities.
+        void DestroyRenderEntities(std::span<const render::EntityID> entity_ids,
+                                   std::span<const render::CameraID> camera_ids = {},
+                                   std::span<const render::LightID> light_ids = {}) const;
+
         void UpdateRenderEntityTransform(const Transform3DComponent& entity_transform);
 
         // Surface
@@ -82,19 +88,8 @@ namespace brr::vis
 
     private:
         uint64_t m_scene_renderer_id;
-
-        using EntityUpdatePair = std::pair<render::EntityID, glm::mat4>;
-
-        struct CameraUpdateData
-        {
-            render::CameraID camera_id;
-            float camera_fov_y;
-            float camera_near;
-            float camera_far;
-        };
-
-        ContiguousPool<render::EntityID, EntityUpdatePair> m_entity_updates;
-        ContiguousPool<render::CameraID, CameraUpdateData> m_camera_updates;
+        // Owned by the SceneRenderer. Valid until the SceneRenderer destruction command is pushed.
+        render::TransformChannel* m_transform_channel;
     };
 }
 